@@ -20,10 +20,39 @@
 #include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 //*****************************************************************************
 // Global Defines
 //*****************************************************************************
 
+/**
+ * @brief Number of buckets of a residence time histogram.
+ *
+ * Bucket 0 counts residence times below 1 us, bucket i (i > 0) counts
+ * [2^(i-1), 2^i) us; the last bucket also takes everything above.
+ */
+#define M_CFIFO_LATENCY_BUCKETS 24
+
+/**
+ * @brief Number of outstanding write grants per FIFO (@ref m_cfifo_This_Grant).
+ */
+#ifdef CONFIG_M_CFIFO_MAX_GRANTS
+#define M_CFIFO_MAX_GRANTS CONFIG_M_CFIFO_MAX_GRANTS
+#else
+#define M_CFIFO_MAX_GRANTS 4
+#endif
+
+/**
+ * @brief Task notification index used by @ref m_cfifo_This_PopBlockWait.
+ *
+ * Application code must not use this index on tasks that wait on a FIFO.
+ */
+#ifdef CONFIG_M_CFIFO_NOTIFY_INDEX
+#define M_CFIFO_NOTIFY_INDEX CONFIG_M_CFIFO_NOTIFY_INDEX
+#else
+#define M_CFIFO_NOTIFY_INDEX (configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 ? 1 : 0)
+#endif
+
 
 //*****************************************************************************
 // Global Types
@@ -47,6 +76,182 @@ typedef enum
 }m_cfifo_tDirection;
 
 
+/**
+ * @brief Transform applied while popping with @ref m_cfifo_This_PopBlockTransform.
+ *
+ * - `M_CFIFO_TRANSFORM_NONE`    plain copy
+ * - `M_CFIFO_TRANSFORM_XOR`     XOR every byte with a mask
+ * - `M_CFIFO_TRANSFORM_BITREV`  reverse the bit order of every byte (LSB-first SPI)
+ * - `M_CFIFO_TRANSFORM_BSWAP16` swap the bytes of every 16-bit word
+ * - `M_CFIFO_TRANSFORM_BSWAP32` swap the bytes of every 32-bit word
+ */
+typedef enum
+{
+  M_CFIFO_TRANSFORM_NONE,
+  M_CFIFO_TRANSFORM_XOR,
+  M_CFIFO_TRANSFORM_BITREV,
+  M_CFIFO_TRANSFORM_BSWAP16,
+  M_CFIFO_TRANSFORM_BSWAP32
+}m_cfifo_tTransform;
+
+
+/**
+ * @brief Token bucket state for rate-limited popping.
+ *
+ * Attached to a FIFO with @ref m_cfifo_SetRateLimit. Every `interval`
+ * ticks `bytes_per_interval` tokens are added, up to `burst`; each
+ * popped byte consumes one token.
+ */
+typedef struct
+{
+  uint32_t bytes_per_interval;
+  TickType_t interval;
+  uint32_t burst;
+  uint32_t tokens;
+  TickType_t last_refill;
+}m_cfifo_tRateLimit;
+
+
+/**
+ * @brief Kind of FreeRTOS object guarding a FIFO.
+ *
+ * - `M_CFIFO_LOCK_TYPE_BINARY` binary semaphore (default)
+ * - `M_CFIFO_LOCK_TYPE_MUTEX`  mutex with priority inheritance: a
+ *                              low-priority holder is boosted while a
+ *                              higher-priority task waits, which bounds
+ *                              the wait under priority inversion
+ */
+typedef enum
+{
+  M_CFIFO_LOCK_TYPE_BINARY,
+  M_CFIFO_LOCK_TYPE_MUTEX
+}m_cfifo_tLockType;
+
+
+/**
+ * @brief Lock acquisition policy of a FIFO.
+ *
+ * - `M_CFIFO_LOCK_BLOCK`    block in `xSemaphoreTake` when contended
+ * - `M_CFIFO_LOCK_ADAPTIVE` on multi-core chips spin for a self-tuned
+ *                           number of attempts first, then block
+ */
+typedef enum
+{
+  M_CFIFO_LOCK_BLOCK,
+  M_CFIFO_LOCK_ADAPTIVE
+}m_cfifo_tLockPolicy;
+
+
+/**
+ * @brief Lock counters of a FIFO, see @ref m_cfifo_GetLockStats.
+ *
+ * - `acquisitions`  successful lock acquisitions
+ * - `contended`     acquisitions that found the lock taken
+ * - `spin_acquired` contended acquisitions that succeeded while spinning
+ * - `blocked`       contended acquisitions that had to block
+ * - `spin_avg`      average spin attempts (x16), exhausted spins count as 0
+ * - `spin_budget`   current spin limit derived from `spin_avg`
+ *
+ * The spin success rate is `spin_acquired / contended`.
+ */
+typedef struct
+{
+  uint32_t acquisitions;
+  uint32_t contended;
+  uint32_t spin_acquired;
+  uint32_t blocked;
+  uint16_t spin_avg;
+  uint16_t spin_budget;
+}m_cfifo_tLockStats;
+
+
+/**
+ * @brief Sampled residence time histogram of a FIFO.
+ *
+ * Attached with @ref m_cfifo_SetLatencyHistogram. Every `every`-th
+ * pushed byte is timestamped; when that byte is popped its residence
+ * time is added to `buckets`. Only one sample is in flight at a time,
+ * samples due while one is pending are counted in `skipped`.
+ */
+typedef struct
+{
+  uint32_t every;
+  uint32_t countdown;
+  uint16_t ahead;
+  bool in_flight;
+  int64_t stamp;
+
+  uint32_t samples;
+  uint32_t skipped;
+  uint32_t max_us;
+  uint32_t buckets[M_CFIFO_LATENCY_BUCKETS];
+}m_cfifo_tLatency;
+
+
+/**
+ * @brief Consumer blocked in @ref m_cfifo_This_PopBlockWait.
+ *
+ * Lives on the waiting task's stack while it is registered with a FIFO.
+ * A producer that finds the FIFO empty copies directly into `data`.
+ */
+typedef struct
+{
+  TaskHandle_t task;
+  uint8_t* data;
+  uint16_t length;
+  uint16_t received;
+}m_cfifo_tWaiter;
+
+
+/**
+ * @brief Outstanding write grant of @ref m_cfifo_This_Grant.
+ *
+ * Grants are kept in the order they were handed out; `offset` is the
+ * start of the granted region in the data buffer. An `aborted` region
+ * is skipped instead of published.
+ */
+typedef struct
+{
+  uint16_t offset;
+  uint16_t length;
+  uint8_t id;
+  bool done;
+  bool aborted;
+}m_cfifo_tGrant;
+
+
+/**
+ * @brief Snapshot of the read/write state of a FIFO.
+ *
+ * Used to persist a FIFO together with its buffer content and to
+ * restore it later with @ref m_cfifo_This_RestoreState. `wrap_gap` is
+ * the unused tail of an early wrap, see @ref m_cfifo_This_Reserve.
+ */
+typedef struct
+{
+  uint16_t buffer_size;
+  uint16_t used_count;
+  uint16_t rdPtr;
+  uint16_t wrPtr;
+  uint16_t wrap_gap;
+}m_cfifo_tState;
+
+
+/**
+ * @brief Called with the FIFO locked whenever stored bytes are released.
+ *
+ * Runs after a pop, skip or ack freed `released` bytes, and before the
+ * freed space can be handed to a writer. A clear, set-full or restore
+ * replaces the content and is reported with `released` 0. Must not call
+ * FIFO functions.
+ *
+ * @param state    Read/write state after the release.
+ * @param released Number of bytes taken from the front, 0 for a reset.
+ * @param arg      Argument given to @ref m_cfifo_SetReleaseHook.
+ */
+typedef void (*m_cfifo_tReleaseHook)(const m_cfifo_tState* state, uint16_t released, void* arg);
+
+
 /**
  * @brief Control structure for a circular FIFO byte buffer.
  *
@@ -59,6 +264,17 @@ typedef enum
  * - A working data buffer may be assigned with @ref m_cfifo_ConfigBuffer.
  * - If no buffer is configured, pop operations return `dummy_byte`.
  *
+ * `sent_count` is the send cursor of @ref m_cfifo_This_Read, counted
+ * from `rdPtr`: bytes read but not yet acknowledged stay stored.
+ * `wrap_gap` is the unused tail left by @ref m_cfifo_This_Reserve when
+ * it wrapped early; readers skip it.
+ * `rd_total`/`wr_total` are the absolute stream offsets of `rdPtr` and
+ * `wrPtr`, see @ref m_cfifo_GetStreamOffsets.
+ * `release_hook` is called on every release of stored bytes, see
+ * @ref m_cfifo_SetReleaseHook.
+ * `grant_lock` guards the grant list against
+ * @ref m_cfifo_This_CommitFromISR of this FIFO only.
+ *
  * The FIFO implements circular wrapping for both read and write indices.
  */
 typedef struct _cfifo
@@ -71,12 +287,49 @@ typedef struct _cfifo
   uint16_t used_count;
   uint16_t rdPtr;
   uint16_t wrPtr;
+  uint16_t sent_count;
+  uint16_t wrap_gap;
+  uint64_t rd_total;
+  uint64_t wr_total;
   
   uint8_t dummy_byte;
   SemaphoreHandle_t semaphore;
+
+  m_cfifo_tRateLimit* rate_limit;
+  m_cfifo_tWaiter* waiter;
+  m_cfifo_tLatency* latency;
+  m_cfifo_tReleaseHook release_hook;
+  void* release_arg;
+
+  m_cfifo_tLockType lock_type;
+  m_cfifo_tLockPolicy lock_policy;
+  m_cfifo_tLockStats lock_stats;
+
+  m_cfifo_tGrant grants[M_CFIFO_MAX_GRANTS];
+  uint8_t grant_count;
+  uint8_t grant_seq;
+  portMUX_TYPE grant_lock;
+
+  uint16_t peak_count;
+  const char* name;
+  struct _cfifo* registry_next;
 }m_cfifo_tCFifo;
 
 
+/**
+ * @brief Contiguous memory region inside a FIFO data buffer.
+ *
+ * Filled by the descriptor export functions such as
+ * @ref m_cfifo_This_GetReadDescriptors so that DMA engines can transfer
+ * directly from or into `m_cfifo_tCFifo::buffer`.
+ */
+typedef struct
+{
+  uint8_t* address;
+  uint16_t length;
+}m_cfifo_tDescriptor;
+
+
 //*****************************************************************************
 // Global Variable Declarations (Extern)
 //*****************************************************************************
@@ -98,6 +351,36 @@ typedef struct _cfifo
 bool m_cfifo_InitBuffer(m_cfifo_tCFifo* cfifo);
 
 
+/**
+ * @brief Initialize a FIFO structure using caller-provided semaphore storage.
+ *
+ * Same as @ref m_cfifo_InitBuffer, but the binary semaphore is created
+ * inside @p semaphore_buffer instead of being allocated from the heap.
+ * Used by @ref m_cfifo_Pool_Init to carve lock objects from an arena.
+ *
+ * @param cfifo Pointer to a FIFO instance to initialize.
+ * @param semaphore_buffer Storage for the semaphore; must outlive the FIFO.
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_InitBufferStatic(m_cfifo_tCFifo* cfifo, StaticSemaphore_t* semaphore_buffer);
+
+
+/**
+ * @brief Initialize a FIFO structure with a selectable lock type.
+ *
+ * Same as @ref m_cfifo_InitBuffer / @ref m_cfifo_InitBufferStatic, but
+ * the lock may be a priority-inheritance mutex. Use the mutex for FIFOs
+ * shared between tasks of different priority, e.g. a low-priority logger
+ * and a high-priority control task. Mutexes must not be used from ISRs.
+ *
+ * @param cfifo Pointer to a FIFO instance to initialize.
+ * @param lock_type Kind of lock to create.
+ * @param semaphore_buffer Storage for the lock, or NULL to allocate from the heap.
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_InitBufferLock(m_cfifo_tCFifo* cfifo, m_cfifo_tLockType lock_type, StaticSemaphore_t* semaphore_buffer);
+
+
 /**
  * @brief Link a FIFO as the next buffer in a cascade.
  *
@@ -134,6 +417,89 @@ bool m_cfifo_ConfigBuffer(m_cfifo_tCFifo* cfifo, const void* buffer, uint16_t bu
 bool m_cfifo_SetDummyByte(m_cfifo_tCFifo* cfifo, uint8_t data);
 
 
+/**
+ * @brief Select how a contended FIFO lock is acquired.
+ *
+ * With @ref M_CFIFO_LOCK_ADAPTIVE a task that finds the lock taken
+ * retries without sleeping for up to `spin_budget` attempts before it
+ * blocks. The budget follows the number of attempts recent successful
+ * spins needed, i.e. the typical hold time of the lock; spins that run
+ * out shrink it, so long hold times fall back to blocking. Setting a
+ * policy restarts the budget. On single-core chips the policy behaves
+ * like @ref M_CFIFO_LOCK_BLOCK.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param policy Lock policy.
+ * @return true if the policy was set, false otherwise.
+ */
+bool m_cfifo_SetLockPolicy(m_cfifo_tCFifo* cfifo, m_cfifo_tLockPolicy policy);
+
+
+/**
+ * @brief Read the lock counters of a FIFO.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param stats Receives the counters.
+ * @param reset Clear the counters (not the spin budget) after reading.
+ * @return true if the counters were read, false otherwise.
+ */
+bool m_cfifo_GetLockStats(m_cfifo_tCFifo* cfifo, m_cfifo_tLockStats* stats, bool reset);
+
+
+/**
+ * @brief Move a FIFO to a new storage buffer while keeping its content.
+ *
+ * Unlike @ref m_cfifo_ConfigBuffer, the stored bytes are preserved: they
+ * are copied with at most two memcpys to the start of @p buffer, and
+ * writing continues directly behind them. The old buffer is no longer
+ * referenced afterwards and may be freed by the caller. The peak usage
+ * is clamped to the new size. The move is refused while write grants
+ * are outstanding, as they point into the old buffer.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param buffer New memory buffer; must not overlap the current one.
+ * @param buffer_size Size of the new buffer in bytes.
+ * @return true if the FIFO was moved, false if the content does not fit
+ *         or a grant is outstanding.
+ */
+bool m_cfifo_This_Resize(m_cfifo_tCFifo* cfifo, const void* buffer, uint16_t buffer_size);
+
+
+/**
+ * @brief Get the highest usage seen since init or the last reset.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param reset Restart peak tracking at the current usage.
+ * @return Peak number of used bytes.
+ */
+uint16_t m_cfifo_This_GetPeak(m_cfifo_tCFifo* cfifo, bool reset);
+
+
+/**
+ * @brief Take a consistent snapshot of the FIFO read/write state.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param state Destination of the snapshot.
+ * @return true if the snapshot was taken, false otherwise.
+ */
+bool m_cfifo_This_GetState(m_cfifo_tCFifo* cfifo, m_cfifo_tState* state);
+
+
+/**
+ * @brief Restore a previously saved read/write state.
+ *
+ * The buffer must already be configured with the same size and hold the
+ * content belonging to @p state. Inconsistent states are rejected; a
+ * `wrap_gap` is only valid while the stored bytes reach the gap.
+ * Outstanding grants are not part of the state and are dropped.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param state Snapshot to restore.
+ * @return true if the state was restored, false if it is invalid.
+ */
+bool m_cfifo_This_RestoreState(m_cfifo_tCFifo* cfifo, const m_cfifo_tState* state);
+
+
 /**
  * @brief Push a byte into a single FIFO.
  *
@@ -147,6 +513,20 @@ bool m_cfifo_SetDummyByte(m_cfifo_tCFifo* cfifo, uint8_t data);
 bool m_cfifo_This_Push(m_cfifo_tCFifo* cfifo, uint8_t data);
 
 
+/**
+ * @brief Push a block of bytes into a single FIFO.
+ *
+ * Copies as many bytes as fit with at most two memcpys under a single
+ * lock acquisition. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param data Pointer to the bytes to push.
+ * @param length Number of bytes to push.
+ * @return Number of bytes actually added.
+ */
+uint16_t m_cfifo_This_PushBlock(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length);
+
+
 /**
  * @brief Push a byte into a cascading chain of FIFOs.
  *
@@ -160,6 +540,21 @@ bool m_cfifo_This_Push(m_cfifo_tCFifo* cfifo, uint8_t data);
 bool m_cfifo_All_Push(m_cfifo_tCFifo* cfifo, uint8_t data);
 
 
+/**
+ * @brief Push a block of bytes into a cascading chain of FIFOs.
+ *
+ * Fills the first FIFO and continues with the next buffer once the
+ * current one is full, like repeated @ref m_cfifo_All_Push calls, but
+ * with contiguous memcpys per segment under a single lock acquisition.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param data Pointer to the bytes to push.
+ * @param length Number of bytes to push.
+ * @return Number of bytes stored in the cascade.
+ */
+uint32_t m_cfifo_All_PushBlock(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint32_t length);
+
+
 
 /**
  * @brief Pop a byte from a single FIFO.
@@ -186,6 +581,256 @@ bool m_cfifo_This_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data);
 bool m_cfifo_All_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data);
 
 
+/**
+ * @brief Pop a block of bytes from a cascading chain of FIFOs.
+ *
+ * Drains the first FIFO and continues with the next buffer once the
+ * current one is empty, like repeated @ref m_cfifo_All_Pop calls, but
+ * with contiguous memcpys per segment under a single lock acquisition.
+ * Honors a rate limit attached to the first FIFO.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to pop.
+ * @return Number of bytes retrieved.
+ */
+uint32_t m_cfifo_All_PopBlock(m_cfifo_tCFifo* cfifo, uint8_t* data, uint32_t length);
+
+
+/**
+ * @brief Pop a block of bytes from a single FIFO.
+ *
+ * Copies up to @p length bytes with at most two memcpys under a single
+ * lock acquisition. Honors an attached rate limit. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to pop.
+ * @return Number of bytes retrieved.
+ */
+uint16_t m_cfifo_This_PopBlock(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Pop a block of bytes and transform them in the same pass.
+ *
+ * Like @ref m_cfifo_This_PopBlock, but applies @p transform while
+ * copying out of the ring, so no second pass over @p data is needed.
+ * For the byte swap transforms @p length is rounded down to whole words;
+ * words that straddle the wrap point are handled. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to pop.
+ * @param transform Transform to apply.
+ * @param mask XOR mask for @ref M_CFIFO_TRANSFORM_XOR, ignored otherwise.
+ * @return Number of bytes retrieved (a multiple of the word size).
+ */
+uint16_t m_cfifo_This_PopBlockTransform(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, m_cfifo_tTransform transform, uint8_t mask);
+
+
+/**
+ * @brief Pop a block of bytes, waiting for data if the FIFO is empty.
+ *
+ * Returns as soon as at least one byte was retrieved. While the calling
+ * task waits, a producer pushing into the empty FIFO copies directly into
+ * @p data and wakes the task; the bytes never pass through the ring
+ * buffer. Any other write, e.g. @ref m_cfifo_This_WriteDone after DMA
+ * or a published grant, wakes the task to pop from the ring. Only one
+ * task may wait on a FIFO at a time. Uses the task
+ * notification @ref M_CFIFO_NOTIFY_INDEX of the calling task. Honors an
+ * attached rate limit.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to pop.
+ * @param timeout Maximum time to wait in ticks.
+ * @return Number of bytes retrieved, 0 on timeout or if another task
+ *         is already waiting.
+ */
+uint16_t m_cfifo_This_PopBlockWait(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, TickType_t timeout);
+
+
+/**
+ * @brief Read bytes without freeing them (send cursor).
+ *
+ * Copies up to @p length bytes following the send cursor and advances
+ * it. The bytes keep occupying the FIFO until they are released with
+ * @ref m_cfifo_This_Ack, so the FIFO itself serves as retransmit buffer.
+ * Pops release acknowledged and unacknowledged bytes alike. Honors an
+ * attached rate limit. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to read.
+ * @return Number of bytes read.
+ */
+uint16_t m_cfifo_This_Read(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Release bytes delivered by @ref m_cfifo_This_Read.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param length Number of acknowledged bytes, at most the bytes read.
+ * @return true if the bytes were released, false otherwise.
+ */
+bool m_cfifo_This_Ack(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Move the send cursor back to the oldest unacknowledged byte.
+ *
+ * The next @ref m_cfifo_This_Read delivers all unacknowledged bytes again.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return true on success, false otherwise.
+ */
+bool m_cfifo_This_Rewind(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Get the absolute stream offsets of the read and write position.
+ *
+ * Both count bytes since stream start and never decrease within a
+ * stream; their difference is the usage. Clearing counts the dropped
+ * bytes as read, setting full counts the fill as written.
+ * @ref m_cfifo_ConfigBuffer restarts the stream at offset 0 with the
+ * buffer full, so its fill occupies [0, buffer_size) and the first byte
+ * pushed after the following clear has offset buffer_size. Call
+ * @ref m_cfifo_SetStreamOffset after the clear to number the payload
+ * from another offset.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param rd_offset Receives the offset of the oldest stored byte, may be NULL.
+ * @param wr_offset Receives the offset of the next byte to push, may be NULL.
+ * @return true on success, false otherwise.
+ */
+bool m_cfifo_GetStreamOffsets(m_cfifo_tCFifo* cfifo, uint64_t* rd_offset, uint64_t* wr_offset);
+
+
+/**
+ * @brief Rebase the stream offsets, e.g. after restoring a saved state.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param rd_offset New offset of the oldest stored byte.
+ * @return true on success, false otherwise.
+ */
+bool m_cfifo_SetStreamOffset(m_cfifo_tCFifo* cfifo, uint64_t rd_offset);
+
+
+/**
+ * @brief Copy stored bytes starting at an absolute stream offset.
+ *
+ * Nothing is consumed. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param offset Stream offset of the first byte to copy.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes.
+ * @return Number of bytes copied, 0 if @p offset is no longer or not yet stored.
+ */
+uint16_t m_cfifo_This_PeekAt(m_cfifo_tCFifo* cfifo, uint64_t offset, uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Drop all bytes before an absolute stream offset.
+ *
+ * O(1), the bytes are not touched. Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param offset New read offset, between the current read and write offset.
+ * @return true if skipped, false if @p offset is out of range.
+ */
+bool m_cfifo_This_SkipTo(m_cfifo_tCFifo* cfifo, uint64_t offset);
+
+
+/**
+ * @brief Attach or remove a token-bucket rate limit.
+ *
+ * While attached, @ref m_cfifo_This_Pop, @ref m_cfifo_This_PopBlock and
+ * @ref m_cfifo_All_Pop (called on this FIFO) release at most
+ * @p bytes_per_interval bytes per @p interval ticks, with bursts up to
+ * @p burst bytes. The bucket starts full.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param limit Caller-owned token bucket storage, or NULL to remove the limit.
+ * @param bytes_per_interval Tokens added per interval.
+ * @param interval Refill interval in ticks.
+ * @param burst Maximum number of tokens.
+ * @return true if the limit was applied, false otherwise.
+ */
+bool m_cfifo_SetRateLimit(m_cfifo_tCFifo* cfifo, m_cfifo_tRateLimit* limit, uint32_t bytes_per_interval, TickType_t interval, uint32_t burst);
+
+
+/**
+ * @brief Get the time until the rate limit releases the next byte.
+ *
+ * Lets a consumer block exactly as long as needed instead of polling.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return Ticks to wait, 0 if bytes may be popped now or no limit is attached.
+ */
+TickType_t m_cfifo_GetRateLimitDelay(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Attach or remove a residence time histogram.
+ *
+ * The histogram is cleared when attached. Sampling costs one timer read
+ * per sampled byte and a few integer operations per push and pop, so it
+ * may stay enabled in production builds.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param latency Caller-owned histogram storage, or NULL to detach.
+ * @param every Sample every n-th pushed byte (at least 1).
+ * @return true if the histogram was attached or removed, false otherwise.
+ */
+bool m_cfifo_SetLatencyHistogram(m_cfifo_tCFifo* cfifo, m_cfifo_tLatency* latency, uint32_t every);
+
+
+/**
+ * @brief Take a consistent copy of the attached residence time histogram.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param copy Receives the histogram.
+ * @param reset Clear counters and buckets after copying.
+ * @return true if a histogram is attached and was copied, false otherwise.
+ */
+bool m_cfifo_GetLatencyHistogram(m_cfifo_tCFifo* cfifo, m_cfifo_tLatency* copy, bool reset);
+
+
+/**
+ * @brief Attach or remove a hook called on every release of stored bytes.
+ *
+ * Lets a persistence layer record the new read position before freed
+ * space can be overwritten, see @ref m_cfifo_tReleaseHook.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param hook Hook function, or NULL to detach.
+ * @param arg Argument passed to the hook.
+ * @return true if the hook was attached or removed, false otherwise.
+ */
+bool m_cfifo_SetReleaseHook(m_cfifo_tCFifo* cfifo, m_cfifo_tReleaseHook hook, void* arg);
+
+
+/**
+ * @brief Search the stored bytes of a single FIFO for a byte pattern.
+ *
+ * Scans from the read pointer over the wrap point without copying or
+ * consuming data. Candidates for the first pattern byte are located with
+ * SSE2/NEON on host builds and word-parallel compares on the targets.
+ * Thread-safe.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param pattern Pattern to search for (e.g. a sync word).
+ * @param length Pattern length in bytes.
+ * @param offset Receives the match position relative to the read pointer.
+ * @return true if the pattern was found, false otherwise.
+ */
+bool m_cfifo_This_FindPattern(m_cfifo_tCFifo* cfifo, const uint8_t* pattern, uint16_t length, uint16_t* offset);
+
+
 /**
  * @brief Clear all data from a single FIFO.
  *
@@ -304,4 +949,216 @@ bool m_cfifo_This_IsFull(m_cfifo_tCFifo* cfifo);
 bool m_cfifo_All_IsFull(m_cfifo_tCFifo* cfifo);
 
 
+/**
+ * @brief Describe the readable region of a single FIFO.
+ *
+ * Fills up to two descriptors (before and after the wrap point) covering
+ * all stored bytes in FIFO order. The FIFO is not modified; call
+ * @ref m_cfifo_This_ReadDone once the transfer has completed.
+ *
+ * Only one reader may hold exported descriptors at a time.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param desc Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+uint8_t m_cfifo_This_GetReadDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Describe the readable regions of a cascade of FIFOs.
+ *
+ * Concatenates the readable regions of every buffer in the cascade in
+ * the order used by @ref m_cfifo_All_Pop.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param desc Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+uint8_t m_cfifo_All_GetReadDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Describe the writable region of a single FIFO.
+ *
+ * Fills up to two descriptors covering all free bytes in the order they
+ * will be filled. Call @ref m_cfifo_This_WriteDone once the transfer has
+ * completed to publish the written bytes.
+ *
+ * Only one writer may hold exported descriptors at a time.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param desc Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+uint8_t m_cfifo_This_GetWriteDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Describe the writable regions of a cascade of FIFOs.
+ *
+ * Concatenates the writable regions of every buffer in the cascade in
+ * the order used by @ref m_cfifo_All_Push.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param desc Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+uint8_t m_cfifo_All_GetWriteDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Complete a read transfer on a single FIFO.
+ *
+ * Advances `rdPtr` by @p length bytes and releases the space.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param length Number of bytes consumed from the exported descriptors.
+ * @return true if the bytes were released, false if @p length exceeds the usage.
+ */
+bool m_cfifo_This_ReadDone(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Complete a read transfer on a cascade of FIFOs.
+ *
+ * Releases @p length bytes segment by segment, starting at the first FIFO.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param length Number of bytes consumed from the exported descriptors.
+ * @return true if the bytes were released, false if @p length exceeds the usage.
+ */
+bool m_cfifo_All_ReadDone(m_cfifo_tCFifo* cfifo, uint32_t length);
+
+
+/**
+ * @brief Complete a write transfer on a single FIFO.
+ *
+ * Advances `wrPtr` by @p length bytes and makes them available to readers.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param length Number of bytes written into the exported descriptors.
+ * @return true if the bytes were published, false if @p length exceeds the free space.
+ */
+bool m_cfifo_This_WriteDone(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Complete a write transfer on a cascade of FIFOs.
+ *
+ * Publishes @p length bytes segment by segment, starting at the first FIFO.
+ *
+ * @param cfifo Pointer to the first FIFO in the cascade.
+ * @param length Number of bytes written into the exported descriptors.
+ * @return true if the bytes were published, false if @p length exceeds the free space.
+ */
+bool m_cfifo_All_WriteDone(m_cfifo_tCFifo* cfifo, uint32_t length);
+
+
+/**
+ * @brief Reserve a contiguous writable region (bip buffer).
+ *
+ * Returns @p length contiguous bytes at the write position. If the
+ * space up to the end of the buffer is too small but enough space is
+ * free at its start, the write position wraps early; the unused tail
+ * is skipped by readers and released once they pass it. Stored frames
+ * therefore stay contiguous for readers as well.
+ *
+ * Publish the written bytes with @ref m_cfifo_This_WriteDone. Only one
+ * producer may write between reserve and commit. The wrap gap is part
+ * of @ref m_cfifo_tState, so saved states restore it.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param length Number of contiguous bytes required.
+ * @return Start of the region, NULL if no contiguous region of @p length bytes is free.
+ */
+uint8_t* m_cfifo_This_Reserve(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Hand out one of several concurrent write grants.
+ *
+ * Returns a contiguous region of @p length bytes behind all outstanding
+ * grants, wrapping early like @ref m_cfifo_This_Reserve. Up to
+ * @ref M_CFIFO_MAX_GRANTS grants may be filled at the same time, e.g.
+ * by pipelined DMA transfers. While grants are outstanding the FIFO
+ * reports no free space to the other write functions. Publishes grants
+ * completed by @ref m_cfifo_This_CommitFromISR first.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param length Number of contiguous bytes required.
+ * @param grant_id Receives the id to pass to @ref m_cfifo_This_Commit.
+ * @return Start of the region, NULL if no grant slot or no contiguous region is free.
+ */
+uint8_t* m_cfifo_This_Grant(m_cfifo_tCFifo* cfifo, uint16_t length, uint8_t* grant_id);
+
+
+/**
+ * @brief Complete a write grant, in any order.
+ *
+ * Readers see the data of a grant once it and all older grants are
+ * committed. Only the newest outstanding grant may be committed with
+ * fewer bytes than granted (0 cancels it); older grants must be
+ * committed in full, their regions are followed by newer ones, or
+ * aborted with @ref m_cfifo_This_Abort.
+ *
+ * Takes the FIFO lock: task context only, use
+ * @ref m_cfifo_This_CommitFromISR in interrupt handlers.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param grant_id Id returned by @ref m_cfifo_This_Grant.
+ * @param length Number of bytes written into the region.
+ * @return true if committed, false if the id or length is invalid.
+ */
+bool m_cfifo_This_Commit(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length);
+
+
+/**
+ * @brief Complete a write grant from an interrupt handler.
+ *
+ * Same rules as @ref m_cfifo_This_Commit, but only marks the grant as
+ * done under a critical section. The data is published by the next
+ * @ref m_cfifo_This_Grant, @ref m_cfifo_This_Commit,
+ * @ref m_cfifo_This_Abort or @ref m_cfifo_This_PublishGrants from task
+ * context, e.g. in the task the ISR notifies.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param grant_id Id returned by @ref m_cfifo_This_Grant.
+ * @param length Number of bytes written into the region.
+ * @return true if marked, false if the id or length is invalid.
+ */
+bool m_cfifo_This_CommitFromISR(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length);
+
+
+/**
+ * @brief Give up a write grant whose transfer failed.
+ *
+ * The newest outstanding grant is cancelled like a commit of 0 bytes.
+ * Older grants are followed by newer regions: their region is never
+ * published, readers step over it once they read everything in front
+ * of it, and the newer grants become visible then. Call it once the
+ * transfer into the region has stopped. Task context only.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param grant_id Id returned by @ref m_cfifo_This_Grant.
+ * @return true if aborted, false if the id is invalid or already committed.
+ */
+bool m_cfifo_This_Abort(m_cfifo_tCFifo* cfifo, uint8_t grant_id);
+
+
+/**
+ * @brief Publish grants completed by @ref m_cfifo_This_CommitFromISR.
+ *
+ * Task context only.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return true on success, false otherwise.
+ */
+bool m_cfifo_This_PublishGrants(m_cfifo_tCFifo* cfifo);
+
+
 #endif /* M_CFIFO_H_ */
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file m_cfifo_audio.h
+ * @brief Frame-aligned audio sample FIFO on top of m_cfifo.
+ *
+ * An audio handle stores interleaved PCM frames in an m_cfifo ring and
+ * only ever moves whole frames, so a reader never sees a partial frame.
+ * On read, the samples are converted to the requested width and laid
+ * out interleaved, planar or mixed down to mono in the same pass that
+ * copies them out of the ring (zero-copy access through the read
+ * descriptors, no intermediate buffer).
+ *
+ * Typical use: an I2S driver writes 32-bit stereo frames, a codec task
+ * reads 16-bit mono.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_AUDIO_H_
+#define M_CFIFO_AUDIO_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Maximum number of channels per frame.
+ */
+#define M_CFIFO_AUDIO_MAX_CHANNELS 8
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Sample format (signed, native endian).
+ *
+ * Converting from 32 to 16 bit keeps the upper 16 bits, converting from
+ * 16 to 32 bit shifts the sample into the upper 16 bits.
+ */
+typedef enum
+{
+  M_CFIFO_AUDIO_S16,
+  M_CFIFO_AUDIO_S32
+}m_cfifo_tAudioFormat;
+
+
+/**
+ * @brief Output layout of @ref m_cfifo_Audio_Read.
+ *
+ * - `M_CFIFO_AUDIO_INTERLEAVED` L R L R ...
+ * - `M_CFIFO_AUDIO_PLANAR`      L L ... then R R ..., one plane of
+ *                               `max_frames` samples per channel
+ * - `M_CFIFO_AUDIO_MONO`        average of all channels
+ */
+typedef enum
+{
+  M_CFIFO_AUDIO_INTERLEAVED,
+  M_CFIFO_AUDIO_PLANAR,
+  M_CFIFO_AUDIO_MONO
+}m_cfifo_tAudioLayout;
+
+
+/**
+ * @brief Audio FIFO handle.
+ *
+ * The underlying FIFO must only be accessed through the handle, so the
+ * read and write pointers stay frame aligned. One task writes, one reads.
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* cfifo;
+
+  m_cfifo_tAudioFormat format;
+  uint8_t channels;
+  uint8_t frame_size;
+}m_cfifo_tAudio;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize an audio handle and clear its FIFO.
+ *
+ * The buffer size of @p cfifo must be a multiple of the frame size, so
+ * frames never straddle the wrap point.
+ *
+ * @param audio Pointer to the audio handle.
+ * @param cfifo Configured FIFO that stores the frames.
+ * @param format Sample format stored in the FIFO.
+ * @param channels Number of interleaved channels (1..M_CFIFO_AUDIO_MAX_CHANNELS).
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Audio_Init(m_cfifo_tAudio* audio, m_cfifo_tCFifo* cfifo, m_cfifo_tAudioFormat format, uint8_t channels);
+
+
+/**
+ * @brief Write interleaved frames in the stored format.
+ *
+ * @param audio Pointer to the audio handle.
+ * @param frames Interleaved frames.
+ * @param frame_count Number of frames.
+ * @return Number of frames written; only whole frames are written.
+ */
+uint16_t m_cfifo_Audio_Write(m_cfifo_tAudio* audio, const void* frames, uint16_t frame_count);
+
+
+/**
+ * @brief Read frames, converting format and layout on the way.
+ *
+ * @param audio Pointer to the audio handle.
+ * @param out Destination buffer.
+ * @param max_frames Maximum number of frames (and plane length for planar output).
+ * @param format Output sample format.
+ * @param layout Output layout.
+ * @return Number of frames read.
+ */
+uint16_t m_cfifo_Audio_Read(m_cfifo_tAudio* audio, void* out, uint16_t max_frames, m_cfifo_tAudioFormat format, m_cfifo_tAudioLayout layout);
+
+
+/**
+ * @brief Get the number of buffered frames.
+ *
+ * @param audio Pointer to the audio handle.
+ * @return Number of complete frames in the FIFO.
+ */
+uint16_t m_cfifo_Audio_GetFrames(m_cfifo_tAudio* audio);
+
+
+#endif /* M_CFIFO_AUDIO_H_ */
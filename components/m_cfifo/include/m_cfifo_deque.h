@@ -0,0 +1,136 @@
+/**
+ * @file m_cfifo_deque.h
+ * @brief Lock-free work-stealing deque for distributing jobs across cores.
+ *
+ * A bounded Chase-Lev deque on a power-of-two ring of job pointers,
+ * indexed with free-running counters and a mask like the m_cfifo rings.
+ * Each worker owns one deque:
+ *
+ * - the owner pushes and pops jobs at the bottom (LIFO, cache friendly)
+ * - idle workers steal from the top (FIFO, oldest job first) with a
+ *   single compare-and-swap
+ *
+ * Owner operations need no atomic read-modify-write except when the last
+ * job is contested, so a busy worker runs at plain ring speed while the
+ * load still balances across cores without a central locked queue.
+ *
+ * Jobs are opaque pointers, e.g. to packet buffers or m_cfifo segments.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_DEQUE_H_
+#define M_CFIFO_DEQUE_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Cache line size used to keep owner and thief indices apart.
+ */
+#define M_CFIFO_DEQUE_CACHE_LINE 64
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Control structure of a work-stealing deque.
+ *
+ * - `bottom` next free slot, written by the owner only
+ * - `top`    oldest job, advanced by thieves and the owner with CAS
+ *
+ * Both indices run freely; `bottom - top` is the number of jobs.
+ */
+typedef struct
+{
+  void** slots;
+  uint32_t mask;
+  uint8_t pad0[M_CFIFO_DEQUE_CACHE_LINE - sizeof(void**) - sizeof(uint32_t)];
+
+  uint32_t bottom;
+  uint8_t pad1[M_CFIFO_DEQUE_CACHE_LINE - sizeof(uint32_t)];
+
+  uint32_t top;
+  uint8_t pad2[M_CFIFO_DEQUE_CACHE_LINE - sizeof(uint32_t)];
+}m_cfifo_tDeque;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize an empty deque.
+ *
+ * @param deque Pointer to the deque.
+ * @param slots Storage for @p capacity job pointers.
+ * @param capacity Number of slots; must be a power of two.
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Deque_Init(m_cfifo_tDeque* deque, void** slots, uint32_t capacity);
+
+
+/**
+ * @brief Push a job at the bottom (owner only).
+ *
+ * @param deque Pointer to the deque.
+ * @param job Job to push.
+ * @return true if pushed, false if the deque is full.
+ */
+bool m_cfifo_Deque_Push(m_cfifo_tDeque* deque, void* job);
+
+
+/**
+ * @brief Pop the newest job from the bottom (owner only).
+ *
+ * @param deque Pointer to the deque.
+ * @param job Receives the job.
+ * @return true if a job was popped, false if empty or the last job was stolen.
+ */
+bool m_cfifo_Deque_Pop(m_cfifo_tDeque* deque, void** job);
+
+
+/**
+ * @brief Steal the oldest job from the top (any task).
+ *
+ * @param deque Pointer to the deque.
+ * @param job Receives the job.
+ * @return true if a job was stolen, false if empty or another task won the race.
+ */
+bool m_cfifo_Deque_Steal(m_cfifo_tDeque* deque, void** job);
+
+
+/**
+ * @brief Steal from a set of deques, starting at a given victim.
+ *
+ * Visits every deque once in round-robin order, skipping @p self.
+ * Workers typically pass their own index as @p self and rotate @p start.
+ *
+ * @param deques Array of deques.
+ * @param count Number of deques.
+ * @param self Index of the caller's own deque, or @p count for none.
+ * @param start Index of the first victim.
+ * @param job Receives the job.
+ * @return true if a job was stolen, false if all victims came up empty.
+ */
+bool m_cfifo_Deque_StealAny(m_cfifo_tDeque* deques, uint8_t count, uint8_t self, uint8_t start, void** job);
+
+
+/**
+ * @brief Get the approximate number of queued jobs.
+ *
+ * @param deque Pointer to the deque.
+ * @return Number of jobs; exact only while no other task accesses the deque.
+ */
+uint32_t m_cfifo_Deque_GetUsage(m_cfifo_tDeque* deque);
+
+
+#endif /* M_CFIFO_DEQUE_H_ */
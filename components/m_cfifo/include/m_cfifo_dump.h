@@ -0,0 +1,143 @@
+/**
+ * @file m_cfifo_dump.h
+ * @brief Runtime registry and introspection dump of m_cfifo instances.
+ *
+ * FIFOs are registered once with a name. @ref m_cfifo_DumpAll then
+ * prints every registered FIFO with size, usage, peak usage, read and
+ * write pointers, cascade links and lock state through a printf-like
+ * function; @ref m_cfifo_DumpAllBinary emits the same information as
+ * fixed-size records for telemetry upload.
+ *
+ * The registry is a lock-free, insert-only list and the dump reads FIFO
+ * fields without taking their locks, so it may be called at any time,
+ * also while traffic is flowing or a task hangs with a FIFO locked. The
+ * values of a FIFO are then not guaranteed to be mutually consistent.
+ *
+ * Binary layout (little endian): @ref m_cfifo_tDumpHeader followed by
+ * `record_count` @ref m_cfifo_tDumpRecord.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_DUMP_H_
+#define M_CFIFO_DUMP_H_
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Magic value of a binary dump ("MCFD").
+ */
+#define M_CFIFO_DUMP_MAGIC 0x4446434Du
+
+/**
+ * @brief Version of the binary dump format.
+ */
+#define M_CFIFO_DUMP_VERSION 1
+
+/**
+ * @brief Bytes of the FIFO name stored in a binary record (not terminated).
+ */
+#define M_CFIFO_DUMP_NAME_LEN 12
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief printf-like output function, e.g. `printf` or `esp_rom_printf`.
+ */
+typedef int (*m_cfifo_tDumpPrintf)(const char* format, ...);
+
+
+/**
+ * @brief Output callback of the binary dump.
+ *
+ * @param data   Bytes to emit.
+ * @param length Number of bytes.
+ * @param ctx    User context.
+ */
+typedef void (*m_cfifo_tDumpSink)(const void* data, size_t length, void* ctx);
+
+
+/**
+ * @brief Header of a binary dump.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t record_count;
+}m_cfifo_tDumpHeader;
+
+
+/**
+ * @brief One FIFO in a binary dump.
+ *
+ * `id`, `prev` and `next` are the (truncated) addresses of the FIFO and
+ * its cascade neighbours, 0 for none.
+ */
+typedef struct
+{
+  uint32_t id;
+  uint32_t prev;
+  uint32_t next;
+  uint16_t buffer_size;
+  uint16_t used_count;
+  uint16_t peak_count;
+  uint16_t rdPtr;
+  uint16_t wrPtr;
+  uint8_t lock_type;
+  uint8_t lock_held;
+  char name[M_CFIFO_DUMP_NAME_LEN];
+}m_cfifo_tDumpRecord;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Add a FIFO to the dump registry.
+ *
+ * Registered FIFOs stay in the registry for the lifetime of the
+ * program, so they must not be freed. Registering a FIFO again only
+ * updates its name. May be called from any task.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param name Name shown in dumps; must stay valid (e.g. a string literal).
+ * @return true if registered, false otherwise.
+ */
+bool m_cfifo_Register(m_cfifo_tCFifo* cfifo, const char* name);
+
+
+/**
+ * @brief Print all registered FIFOs, one line each.
+ *
+ * @param out printf-like output function.
+ * @return Number of FIFOs printed.
+ */
+uint32_t m_cfifo_DumpAll(m_cfifo_tDumpPrintf out);
+
+
+/**
+ * @brief Emit all registered FIFOs as a binary dump.
+ *
+ * @param sink Output callback.
+ * @param ctx User context handed to @p sink.
+ * @return Number of records emitted.
+ */
+uint32_t m_cfifo_DumpAllBinary(m_cfifo_tDumpSink sink, void* ctx);
+
+
+#endif /* M_CFIFO_DUMP_H_ */
@@ -0,0 +1,200 @@
+/**
+ * @file m_cfifo_mmap.h
+ * @brief Memory-mapped, crash-safe file backing for m_cfifo (Linux target only).
+ *
+ * The FIFO buffer lives in a `MAP_SHARED` mapping of a file. The first
+ * page of the file holds a small header with the FIFO state (`rdPtr`,
+ * `wrPtr`, `used_count`, `wrap_gap`); the ring data follows page aligned:
+ *
+ * | offset      | content                       |
+ * |-------------|-------------------------------|
+ * | 0           | @ref m_cfifo_tMmapHeader      |
+ * | page size   | ring data (`buffer_size`)     |
+ *
+ * Pushed bytes land directly in the page cache and therefore survive a
+ * crash of the process. Written bytes become persistent with
+ * @ref m_cfifo_Mmap_Commit. Released bytes are persisted at once: every
+ * pop, skip or clear writes the new read position to the header before
+ * the freed space can be reused, while the write position stays at the
+ * last commit. So after a crash the FIFO resumes with the committed
+ * bytes that were not yet released, never with space overwritten since.
+ * A restarted process, or an offline reader tool, attaches to the file
+ * without copying.
+ *
+ * The state is stored in two checksummed slots which commits overwrite
+ * alternately. A header write torn by a crash or power loss leaves the
+ * previous slot intact, and the FIFO falls back to the commit before.
+ *
+ * Durability against power loss is selected with @ref m_cfifo_tMmapSync.
+ * `msync` is batched, i.e. issued only every `sync_every` commits.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_MMAP_H_
+#define M_CFIFO_MMAP_H_
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Magic value at the start of a FIFO file ("MCFM").
+ */
+#define M_CFIFO_MMAP_MAGIC 0x4D46434Du
+
+/**
+ * @brief Version of the file layout.
+ */
+#define M_CFIFO_MMAP_VERSION 2
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Durability policy of a memory-mapped FIFO.
+ *
+ * - `M_CFIFO_MMAP_SYNC_NONE`  header updated on commit, no msync; survives
+ *                             process crashes, writeback left to the kernel
+ * - `M_CFIFO_MMAP_SYNC_ASYNC` additionally schedule writeback (MS_ASYNC)
+ * - `M_CFIFO_MMAP_SYNC_FULL`  flush data, then header (MS_SYNC); survives
+ *                             power loss at the last synced commit. The
+ *                             header of every release is flushed as well.
+ */
+typedef enum
+{
+  M_CFIFO_MMAP_SYNC_NONE,
+  M_CFIFO_MMAP_SYNC_ASYNC,
+  M_CFIFO_MMAP_SYNC_FULL
+}m_cfifo_tMmapSync;
+
+
+/**
+ * @brief One committed FIFO state in the file header.
+ *
+ * `sequence` is incremented on every commit and selects the slot
+ * (`sequence & 1`). The remaining fields are the @ref m_cfifo_tState
+ * of that commit. `checksum` covers all preceding fields and is
+ * written last, so a torn or concurrently updated slot fails the check.
+ */
+typedef struct
+{
+  uint32_t sequence;
+  uint16_t used_count;
+  uint16_t rdPtr;
+  uint16_t wrPtr;
+  uint16_t wrap_gap;
+  uint32_t checksum;
+}m_cfifo_tMmapSlot;
+
+
+/**
+ * @brief On-disk header of a memory-mapped FIFO file.
+ *
+ * The valid slot with the higher `sequence` holds the current state.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t data_offset;
+  uint16_t buffer_size;
+  uint16_t reserved;
+  m_cfifo_tMmapSlot slots[2];
+}m_cfifo_tMmapHeader;
+
+
+/**
+ * @brief Handle of a memory-mapped FIFO.
+ *
+ * `persisted` is the state in the newest header slot. `lock` orders
+ * commits against the release hook, which counts the bytes it released
+ * in `released` and the resets in `resets`.
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* cfifo;
+
+  int fd;
+  uint8_t* map;
+  size_t map_size;
+  m_cfifo_tMmapHeader* header;
+  uint32_t sequence;
+
+  SemaphoreHandle_t lock;
+  m_cfifo_tState persisted;
+  uint32_t released;
+  uint32_t resets;
+
+  m_cfifo_tMmapSync policy;
+  uint32_t sync_every;
+  uint32_t commits_since_sync;
+}m_cfifo_tMmap;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Attach a FIFO to a memory-mapped file.
+ *
+ * If @p path holds a valid FIFO file of the same size, the FIFO resumes
+ * with its last committed content, falling back to the commit before if
+ * the newest header slot is damaged; otherwise the file is (re)created
+ * empty. On failure the file is closed and @p cfifo is detached.
+ * @p cfifo must be initialized with @ref m_cfifo_InitBuffer.
+ *
+ * @param mm Pointer to the handle.
+ * @param cfifo FIFO to back with the file.
+ * @param path File path.
+ * @param buffer_size Ring size in bytes.
+ * @param policy Durability policy.
+ * @param sync_every Number of commits per msync (1 = every commit).
+ * @return true if the FIFO was attached, false otherwise.
+ */
+bool m_cfifo_Mmap_Open(m_cfifo_tMmap* mm, m_cfifo_tCFifo* cfifo, const char* path, uint16_t buffer_size, m_cfifo_tMmapSync policy, uint32_t sync_every);
+
+
+/**
+ * @brief Persist the current FIFO state to the file header.
+ *
+ * Makes all bytes written so far part of the state a reopened FIFO
+ * resumes from. Applies the msync policy every `sync_every` commits.
+ *
+ * @param mm Pointer to the handle.
+ * @return true if the state was committed, false otherwise.
+ */
+bool m_cfifo_Mmap_Commit(m_cfifo_tMmap* mm);
+
+
+/**
+ * @brief Force a commit followed by a synchronous msync.
+ *
+ * @param mm Pointer to the handle.
+ * @return true if data and header reached the file, false otherwise.
+ */
+bool m_cfifo_Mmap_Sync(m_cfifo_tMmap* mm);
+
+
+/**
+ * @brief Commit, unmap and close the file.
+ *
+ * The FIFO is detached from its buffer afterwards.
+ *
+ * @param mm Pointer to the handle.
+ * @return true if closed cleanly, false otherwise.
+ */
+bool m_cfifo_Mmap_Close(m_cfifo_tMmap* mm);
+
+
+#endif /* M_CFIFO_MMAP_H_ */
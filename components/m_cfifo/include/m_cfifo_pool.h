@@ -0,0 +1,157 @@
+/**
+ * @file m_cfifo_pool.h
+ * @brief Arena-backed pool and registry for m_cfifo instances.
+ *
+ * A pool carves FIFO control blocks, their semaphores and fixed-size data
+ * segments out of one caller-provided arena. FIFOs are acquired and
+ * released in O(1) without touching the heap, and all live FIFOs of a
+ * pool can be enumerated, e.g. for statistics dumps.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_POOL_H_
+#define M_CFIFO_POOL_H_
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Alignment applied to every region carved from a pool arena.
+ */
+#define M_CFIFO_POOL_ALIGNMENT 8
+
+#define M_CFIFO_POOL_ALIGN(size) \
+  (((size) + (M_CFIFO_POOL_ALIGNMENT - 1)) & ~((size_t)M_CFIFO_POOL_ALIGNMENT - 1))
+
+/**
+ * @brief Number of arena bytes needed for a pool.
+ *
+ * @param segment_size Data buffer size of each FIFO in bytes.
+ * @param count        Number of FIFOs in the pool.
+ */
+#define M_CFIFO_POOL_ARENA_SIZE(segment_size, count)                   \
+  (M_CFIFO_POOL_ALIGN(sizeof(m_cfifo_tCFifo) * (size_t)(count)) +      \
+   M_CFIFO_POOL_ALIGN(sizeof(StaticSemaphore_t) * (size_t)(count)) +   \
+   M_CFIFO_POOL_ALIGN(2 * sizeof(uint16_t) * (size_t)(count)) +        \
+   (size_t)(segment_size) * (size_t)(count))
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Control structure of a FIFO pool.
+ *
+ * `slots` is a permutation of all FIFO indices: the first `live_count`
+ * entries are the acquired FIFOs, the remaining ones are free.
+ * `slot_of` maps a FIFO index back to its position in `slots`, so both
+ * acquire and release are O(1) and live FIFOs are enumerated in O(live).
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* fifos;
+  uint16_t* slots;
+  uint16_t* slot_of;
+  uint8_t* data;
+
+  uint16_t segment_size;
+  uint16_t count;
+  uint16_t live_count;
+
+  StaticSemaphore_t semaphore_buffer;
+  SemaphoreHandle_t semaphore;
+}m_cfifo_tPool;
+
+
+/**
+ * @brief Callback invoked for every live FIFO by @ref m_cfifo_Pool_ForEach.
+ *
+ * @param cfifo Pointer to a live FIFO of the pool.
+ * @param ctx   User context passed to @ref m_cfifo_Pool_ForEach.
+ */
+typedef void (*m_cfifo_tPoolVisitor)(m_cfifo_tCFifo* cfifo, void* ctx);
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize a pool inside a caller-provided arena.
+ *
+ * Every FIFO of the pool is initialized once with its own statically
+ * allocated semaphore and data segment.
+ *
+ * @param pool         Pointer to the pool instance.
+ * @param arena        Memory region, aligned to @ref M_CFIFO_POOL_ALIGNMENT.
+ * @param arena_size   Size of @p arena, at least @ref M_CFIFO_POOL_ARENA_SIZE.
+ * @param segment_size Data buffer size of each FIFO in bytes.
+ * @param count        Number of FIFOs in the pool.
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Pool_Init(m_cfifo_tPool* pool, void* arena, size_t arena_size, uint16_t segment_size, uint16_t count);
+
+
+/**
+ * @brief Acquire an empty, unlinked FIFO from the pool.
+ *
+ * The FIFO starts from defaults on its own arena segment, also if the
+ * previous owner resized it: no rate limit, latency histogram or
+ * release hook, blocking lock policy, cleared lock counters and peak
+ * usage, stream offsets at 0.
+ *
+ * @param pool Pointer to the pool instance.
+ * @return Pointer to the FIFO, or NULL if the pool is exhausted.
+ */
+m_cfifo_tCFifo* m_cfifo_Pool_Acquire(m_cfifo_tPool* pool);
+
+
+/**
+ * @brief Return a FIFO to the pool.
+ *
+ * The FIFO must not be in use by any task and must not be referenced by
+ * a cascade that stays alive.
+ *
+ * @param pool  Pointer to the pool instance.
+ * @param cfifo FIFO previously returned by @ref m_cfifo_Pool_Acquire.
+ * @return true if the FIFO was released, false if it does not belong to the pool.
+ */
+bool m_cfifo_Pool_Release(m_cfifo_tPool* pool, m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Get the number of FIFOs currently acquired from the pool.
+ *
+ * @param pool Pointer to the pool instance.
+ * @return Number of live FIFOs.
+ */
+uint16_t m_cfifo_Pool_GetLiveCount(m_cfifo_tPool* pool);
+
+
+/**
+ * @brief Enumerate all live FIFOs of the pool.
+ *
+ * The pool is locked while enumerating; the visitor must not acquire or
+ * release FIFOs of the same pool.
+ *
+ * @param pool    Pointer to the pool instance.
+ * @param visitor Callback invoked for every live FIFO.
+ * @param ctx     User context handed to @p visitor.
+ * @return Number of visited FIFOs.
+ */
+uint16_t m_cfifo_Pool_ForEach(m_cfifo_tPool* pool, m_cfifo_tPoolVisitor visitor, void* ctx);
+
+
+#endif /* M_CFIFO_POOL_H_ */
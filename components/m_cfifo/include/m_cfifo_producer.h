@@ -0,0 +1,126 @@
+/**
+ * @file m_cfifo_producer.h
+ * @brief Write-combining producer handle for m_cfifo.
+ *
+ * A producer handle collects small writes in a staging area owned by a
+ * single task and publishes them to the FIFO with one bulk push. Data is
+ * published when the staging area is full, on an explicit flush, or once
+ * the oldest staged byte is older than the configured latency.
+ *
+ * The staging size and the latency bound make the trade between
+ * throughput (fewer lock round trips) and latency explicit per FIFO.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_PRODUCER_H_
+#define M_CFIFO_PRODUCER_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Producer handle with private staging area.
+ *
+ * The handle is not thread-safe; each producing task uses its own handle.
+ * Only the publish step locks the target FIFO.
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* cfifo;
+
+  uint8_t* staging;
+  uint16_t staging_size;
+  uint16_t staged;
+
+  TickType_t max_latency;
+  TickType_t first_staged_tick;
+}m_cfifo_tProducer;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize a producer handle.
+ *
+ * @param producer Pointer to the producer handle.
+ * @param cfifo Target FIFO.
+ * @param staging Staging buffer owned by the producer.
+ * @param staging_size Size of @p staging in bytes.
+ * @param max_latency Maximum age of a staged byte in ticks before it is
+ *                    published; 0 publishes on every write,
+ *                    portMAX_DELAY only on full staging area or flush.
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Producer_Init(m_cfifo_tProducer* producer, m_cfifo_tCFifo* cfifo, uint8_t* staging, uint16_t staging_size, TickType_t max_latency);
+
+
+/**
+ * @brief Stage a single byte.
+ *
+ * @param producer Pointer to the producer handle.
+ * @param data Byte to stage.
+ * @return true if the byte was staged, false if staging and FIFO are full.
+ */
+bool m_cfifo_Producer_Push(m_cfifo_tProducer* producer, uint8_t data);
+
+
+/**
+ * @brief Stage a block of bytes.
+ *
+ * @param producer Pointer to the producer handle.
+ * @param data Bytes to stage.
+ * @param length Number of bytes to stage.
+ * @return Number of bytes accepted.
+ */
+uint16_t m_cfifo_Producer_Write(m_cfifo_tProducer* producer, const uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Publish all staged bytes to the FIFO.
+ *
+ * Bytes that do not fit into the FIFO stay staged.
+ *
+ * @param producer Pointer to the producer handle.
+ * @return true if the staging area is empty afterwards, false otherwise.
+ */
+bool m_cfifo_Producer_Flush(m_cfifo_tProducer* producer);
+
+
+/**
+ * @brief Publish staged bytes if the latency deadline has expired.
+ *
+ * Call periodically from the producing task when no further writes
+ * are expected for a while.
+ *
+ * @param producer Pointer to the producer handle.
+ * @return true if the staging area is empty afterwards, false otherwise.
+ */
+bool m_cfifo_Producer_Poll(m_cfifo_tProducer* producer);
+
+
+/**
+ * @brief Get the number of staged, not yet published bytes.
+ *
+ * @param producer Pointer to the producer handle.
+ * @return Number of staged bytes.
+ */
+uint16_t m_cfifo_Producer_GetStaged(m_cfifo_tProducer* producer);
+
+
+#endif /* M_CFIFO_PRODUCER_H_ */
@@ -0,0 +1,122 @@
+/**
+ * @file m_cfifo_shard.h
+ * @brief Sharded FIFO: one m_cfifo per core or producer, merged on read.
+ *
+ * Producers on different cores contend on the semaphore of a single
+ * FIFO. A sharded FIFO gives every core (or every producer) its own
+ * m_cfifo_tCFifo, so a push only takes the lock of the local shard.
+ * The consumer drains the shards round-robin and learns which shard the
+ * bytes came from, so per-producer byte order is preserved.
+ *
+ * A single aggregate usage counter is updated atomically on every
+ * transfer; the consumer can poll it without touching any shard lock.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_SHARD_H_
+#define M_CFIFO_SHARD_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Maximum number of shards.
+ */
+#define M_CFIFO_SHARD_MAX 8
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Control structure of a sharded FIFO.
+ *
+ * - `shards` initialized and configured FIFOs, one per core or producer
+ * - `cursor` shard the consumer visits first on the next pop
+ * - `usage`  bytes stored in all shards
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* shards[M_CFIFO_SHARD_MAX];
+  uint8_t count;
+  uint8_t cursor;
+  uint32_t usage;
+}m_cfifo_tShard;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize a sharded FIFO.
+ *
+ * The shard FIFOs must be initialized and configured and must not be
+ * cascaded or used directly afterwards.
+ *
+ * @param shard Pointer to the sharded FIFO.
+ * @param fifos Array of @p count FIFO pointers.
+ * @param count Number of shards (1..M_CFIFO_SHARD_MAX).
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Shard_Init(m_cfifo_tShard* shard, m_cfifo_tCFifo* const* fifos, uint8_t count);
+
+
+/**
+ * @brief Push bytes into the shard of the calling core.
+ *
+ * @param shard Pointer to the sharded FIFO.
+ * @param data Bytes to push.
+ * @param length Number of bytes.
+ * @return Number of bytes pushed.
+ */
+uint16_t m_cfifo_Shard_Push(m_cfifo_tShard* shard, const uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Push bytes into a specific shard (one shard per producer).
+ *
+ * @param shard Pointer to the sharded FIFO.
+ * @param index Shard index.
+ * @param data Bytes to push.
+ * @param length Number of bytes.
+ * @return Number of bytes pushed.
+ */
+uint16_t m_cfifo_Shard_PushTo(m_cfifo_tShard* shard, uint8_t index, const uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Pop bytes from the next non-empty shard (single consumer).
+ *
+ * Shards are visited round-robin; all returned bytes come from one shard.
+ *
+ * @param shard Pointer to the sharded FIFO.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes.
+ * @param index Receives the shard index of the bytes; may be NULL.
+ * @return Number of bytes popped, 0 if all shards are empty.
+ */
+uint16_t m_cfifo_Shard_Pop(m_cfifo_tShard* shard, uint8_t* data, uint16_t length, uint8_t* index);
+
+
+/**
+ * @brief Get the number of bytes stored in all shards.
+ *
+ * Lock-free; reads the aggregate counter only.
+ *
+ * @param shard Pointer to the sharded FIFO.
+ * @return Number of stored bytes.
+ */
+uint32_t m_cfifo_Shard_GetUsage(m_cfifo_tShard* shard);
+
+
+#endif /* M_CFIFO_SHARD_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file m_cfifo_shm.h
+ * @brief Cross-process SPSC FIFO in POSIX shared memory (Linux target only).
+ *
+ * A variant of the m_cfifo ring that can be placed in a `shm_open`
+ * region and used by two processes at once. The shared control block
+ * contains no pointers: the data area is addressed by `data_offset`
+ * relative to the start of the region, so every process may map it at
+ * a different address.
+ *
+ * One process writes and one process reads. Both indices run freely
+ * and are published with acquire/release atomics, so transfers need no
+ * system call as long as the ring is neither empty nor full. Only a
+ * reader waiting on an empty ring, or a writer waiting on a full one,
+ * sleeps on a futex, and the other side issues a wake only if a waiter
+ * is flagged.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_SHM_H_
+#define M_CFIFO_SHM_H_
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Magic value at the start of a shared FIFO region ("MCFS").
+ */
+#define M_CFIFO_SHM_MAGIC 0x5346434Du
+
+/**
+ * @brief Version of the shared memory layout.
+ */
+#define M_CFIFO_SHM_VERSION 1
+
+/**
+ * @brief Cache line size used to keep producer and consumer state apart.
+ */
+#define M_CFIFO_SHM_CACHE_LINE 64
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Shared control block at the start of the region.
+ *
+ * - `wrCount`/`rdCount` free-running byte counters; usage is their difference
+ * - `rd_waiting`        set by a reader sleeping on `wrCount`
+ * - `wr_waiting`        set by a writer sleeping on `rdCount`
+ *
+ * Producer and consumer fields live on separate cache lines.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t buffer_size;
+  uint32_t data_offset;
+  uint8_t pad0[M_CFIFO_SHM_CACHE_LINE - 16];
+
+  uint32_t wrCount;
+  uint32_t wr_waiting;
+  uint8_t pad1[M_CFIFO_SHM_CACHE_LINE - 8];
+
+  uint32_t rdCount;
+  uint32_t rd_waiting;
+  uint8_t pad2[M_CFIFO_SHM_CACHE_LINE - 8];
+}m_cfifo_tShmFifo;
+
+
+/**
+ * @brief Process-local handle of a shared FIFO.
+ *
+ * `buffer_size` is the ring size validated at create or open; the copy
+ * in the shared block is not used afterwards, the peer could change it.
+ */
+typedef struct
+{
+  m_cfifo_tShmFifo* shm;
+  uint8_t* buffer;
+  uint32_t buffer_size;
+  size_t map_size;
+  int fd;
+}m_cfifo_tShm;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Create and map a new shared FIFO.
+ *
+ * @param handle Pointer to the handle.
+ * @param name Shared memory object name (e.g. "/capture").
+ * @param buffer_size Ring size in bytes; must be a power of two.
+ * @return true if created, false otherwise (e.g. name already exists).
+ */
+bool m_cfifo_Shm_Create(m_cfifo_tShm* handle, const char* name, uint32_t buffer_size);
+
+
+/**
+ * @brief Map an existing shared FIFO.
+ *
+ * @param handle Pointer to the handle.
+ * @param name Shared memory object name.
+ * @return true if mapped, false if missing or invalid.
+ */
+bool m_cfifo_Shm_Open(m_cfifo_tShm* handle, const char* name);
+
+
+/**
+ * @brief Unmap a shared FIFO; the shared object itself stays.
+ *
+ * @param handle Pointer to the handle.
+ * @return true if closed, false otherwise.
+ */
+bool m_cfifo_Shm_Close(m_cfifo_tShm* handle);
+
+
+/**
+ * @brief Remove the shared memory object name.
+ *
+ * @param name Shared memory object name.
+ * @return true if removed, false otherwise.
+ */
+bool m_cfifo_Shm_Unlink(const char* name);
+
+
+/**
+ * @brief Write bytes (producer process).
+ *
+ * Waits for free space up to @p timeout_ms until all bytes are written.
+ * Stops if the counters claim more bytes than the ring holds.
+ *
+ * @param handle Pointer to the handle.
+ * @param data Bytes to write.
+ * @param length Number of bytes.
+ * @param timeout_ms Maximum time to wait for space, 0 = do not wait,
+ *                   UINT32_MAX = forever.
+ * @return Number of bytes written.
+ */
+uint32_t m_cfifo_Shm_Write(m_cfifo_tShm* handle, const uint8_t* data, uint32_t length, uint32_t timeout_ms);
+
+
+/**
+ * @brief Read bytes (consumer process).
+ *
+ * Returns as soon as at least one byte is available, waiting up to
+ * @p timeout_ms while the ring is empty. Returns 0 if the counters
+ * claim more bytes than the ring holds.
+ *
+ * @param handle Pointer to the handle.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes.
+ * @param timeout_ms Maximum time to wait for data, 0 = do not wait,
+ *                   UINT32_MAX = forever.
+ * @return Number of bytes read.
+ */
+uint32_t m_cfifo_Shm_Read(m_cfifo_tShm* handle, uint8_t* data, uint32_t length, uint32_t timeout_ms);
+
+
+/**
+ * @brief Get the number of bytes currently stored.
+ *
+ * @param handle Pointer to the handle.
+ * @return Number of used bytes.
+ */
+uint32_t m_cfifo_Shm_GetUsage(m_cfifo_tShm* handle);
+
+
+#endif /* M_CFIFO_SHM_H_ */
@@ -0,0 +1,136 @@
+/**
+ * @file m_cfifo_spsc.h
+ * @brief Lock-free single-producer/single-consumer cascade of m_cfifo segments.
+ *
+ * The queue is a chain of m_cfifo_tCFifo segments linked through their
+ * `prev`/`next` pointers. Each segment is used as a lock-free SPSC ring:
+ * the producer owns `wrPtr`, the consumer owns `rdPtr`, and one byte per
+ * segment is kept free to tell a full ring from an empty one.
+ *
+ * When the producer finds its segment full it takes a segment from the
+ * spare pool and publishes it through an atomic store to `next`. The
+ * consumer retires drained segments back to the pool. No semaphores are
+ * used; `used_count` and `semaphore` of the segments are unused.
+ *
+ * Exactly one task may produce and exactly one task may consume.
+ * Segments handed to this module must not be used with the locked
+ * m_cfifo API at the same time.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_SPSC_H_
+#define M_CFIFO_SPSC_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include "m_cfifo.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Control structure of a lock-free SPSC cascade.
+ *
+ * - `head`      segment currently drained by the consumer
+ * - `tail`      segment currently filled by the producer
+ * - `free_list` spare segments, linked through `next`
+ */
+typedef struct
+{
+  m_cfifo_tCFifo* head;
+  m_cfifo_tCFifo* tail;
+  m_cfifo_tCFifo* free_list;
+}m_cfifo_tSpsc;
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Initialize an SPSC cascade with its first segment.
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param segment Control block of the first segment.
+ * @param buffer Data buffer of the first segment.
+ * @param buffer_size Size of @p buffer in bytes (at least 2).
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool m_cfifo_Spsc_Init(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment, uint8_t* buffer, uint16_t buffer_size);
+
+
+/**
+ * @brief Add a spare segment to the pool of the cascade.
+ *
+ * May be called from any task at any time.
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param segment Control block of the spare segment.
+ * @param buffer Data buffer of the spare segment.
+ * @param buffer_size Size of @p buffer in bytes (at least 2).
+ * @return true if the segment was added, false otherwise.
+ */
+bool m_cfifo_Spsc_AddSegment(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment, uint8_t* buffer, uint16_t buffer_size);
+
+
+/**
+ * @brief Push a byte (producer side).
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param data Byte to push.
+ * @return true if the byte was added, false if all segments are in use and full.
+ */
+bool m_cfifo_Spsc_Push(m_cfifo_tSpsc* spsc, uint8_t data);
+
+
+/**
+ * @brief Push a block of bytes (producer side).
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param data Bytes to push.
+ * @param length Number of bytes to push.
+ * @return Number of bytes added.
+ */
+uint32_t m_cfifo_Spsc_Write(m_cfifo_tSpsc* spsc, const uint8_t* data, uint32_t length);
+
+
+/**
+ * @brief Pop a byte (consumer side).
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param data Pointer to store the retrieved byte.
+ * @return true if a byte was retrieved, false if the cascade is empty.
+ */
+bool m_cfifo_Spsc_Pop(m_cfifo_tSpsc* spsc, uint8_t* data);
+
+
+/**
+ * @brief Pop a block of bytes (consumer side).
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @param data Destination buffer.
+ * @param length Maximum number of bytes to pop.
+ * @return Number of bytes retrieved.
+ */
+uint32_t m_cfifo_Spsc_Read(m_cfifo_tSpsc* spsc, uint8_t* data, uint32_t length);
+
+
+/**
+ * @brief Check if the cascade is empty (consumer side).
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @return true if no byte is available, false otherwise.
+ */
+bool m_cfifo_Spsc_IsEmpty(m_cfifo_tSpsc* spsc);
+
+
+#endif /* M_CFIFO_SPSC_H_ */
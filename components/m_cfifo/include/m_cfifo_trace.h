@@ -0,0 +1,269 @@
+/**
+ * @file m_cfifo_trace.h
+ * @brief Optional hot-path tracing of m_cfifo operations.
+ *
+ * With `CONFIG_M_CFIFO_TRACE` enabled (menuconfig → m_cfifo), every public
+ * m_cfifo entry point records compact binary events (call, push, pop,
+ * block, wake) into a global lock-free trace ring. The pool, producer,
+ * spsc, shm, shard, deque and audio layers record a call event against
+ * their own object; the lock-free spsc, shm and deque additionally record
+ * push and pop counts, since they bypass the traced m_cfifo core. Task
+ * switches can be recorded as well by calling
+ * @ref m_cfifo_Trace_TaskSwitchedIn from the FreeRTOS
+ * `traceTASK_SWITCHED_IN()` hook.
+ *
+ * The ring is exported with @ref m_cfifo_Trace_Dump and converted on the
+ * host into Chrome/Perfetto JSON with `tools/m_cfifo_trace2json.py`.
+ *
+ * With the option disabled, @ref M_CFIFO_TRACE expands to nothing and
+ * no trace code or data is linked.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_TRACE_H_
+#define M_CFIFO_TRACE_H_
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+/**
+ * @brief Magic value at the start of a trace dump ("MCFT").
+ */
+#define M_CFIFO_TRACE_MAGIC 0x5446434Du
+
+/**
+ * @brief Version of the binary dump layout.
+ */
+#define M_CFIFO_TRACE_VERSION 1
+
+#ifdef CONFIG_M_CFIFO_TRACE
+#define M_CFIFO_TRACE(type, cfifo, arg) m_cfifo_Trace_Record((type), (const void*)(cfifo), (uint16_t)(arg))
+#else
+#define M_CFIFO_TRACE(type, cfifo, arg) ((void)0)
+#endif
+
+
+//*****************************************************************************
+// Global Types
+//*****************************************************************************
+
+/**
+ * @brief Kind of a trace event.
+ *
+ * - `M_CFIFO_TRACE_CALL`        public API entered, `arg` = @ref m_cfifo_tTraceApi
+ * - `M_CFIFO_TRACE_PUSH`        bytes stored, `arg` = byte count
+ * - `M_CFIFO_TRACE_POP`         bytes removed, `arg` = byte count
+ * - `M_CFIFO_TRACE_BLOCK`       task blocks on a contended semaphore or
+ *                               waits for data, `arg` = API
+ * - `M_CFIFO_TRACE_WAKE`        blocked task resumed; recorded by another
+ *                               task, that task woke a waiting consumer
+ * - `M_CFIFO_TRACE_TASK_SWITCH` task switched in, `fifo` = 0
+ */
+typedef enum
+{
+  M_CFIFO_TRACE_CALL,
+  M_CFIFO_TRACE_PUSH,
+  M_CFIFO_TRACE_POP,
+  M_CFIFO_TRACE_BLOCK,
+  M_CFIFO_TRACE_WAKE,
+  M_CFIFO_TRACE_TASK_SWITCH
+}m_cfifo_tTraceType;
+
+
+/**
+ * @brief Identifiers of the traced public API functions.
+ *
+ * The order is part of the dump format; append new entries at the end
+ * and keep `tools/m_cfifo_trace2json.py` in sync.
+ */
+typedef enum
+{
+  M_CFIFO_API_CASCADE_AS_NEXT_BUFFER,
+  M_CFIFO_API_CONFIG_BUFFER,
+  M_CFIFO_API_SET_DUMMY_BYTE,
+  M_CFIFO_API_THIS_PUSH,
+  M_CFIFO_API_THIS_PUSH_BLOCK,
+  M_CFIFO_API_ALL_PUSH,
+  M_CFIFO_API_THIS_POP,
+  M_CFIFO_API_ALL_POP,
+  M_CFIFO_API_THIS_CLEAR,
+  M_CFIFO_API_ALL_CLEAR,
+  M_CFIFO_API_THIS_SET_FULL,
+  M_CFIFO_API_ALL_SET_FULL,
+  M_CFIFO_API_THIS_GET_SIZE,
+  M_CFIFO_API_ALL_GET_SIZE,
+  M_CFIFO_API_THIS_GET_USAGE,
+  M_CFIFO_API_ALL_GET_USAGE,
+  M_CFIFO_API_THIS_IS_EMPTY,
+  M_CFIFO_API_ALL_IS_EMPTY,
+  M_CFIFO_API_THIS_IS_FULL,
+  M_CFIFO_API_ALL_IS_FULL,
+  M_CFIFO_API_THIS_GET_READ_DESCRIPTORS,
+  M_CFIFO_API_ALL_GET_READ_DESCRIPTORS,
+  M_CFIFO_API_THIS_GET_WRITE_DESCRIPTORS,
+  M_CFIFO_API_ALL_GET_WRITE_DESCRIPTORS,
+  M_CFIFO_API_THIS_READ_DONE,
+  M_CFIFO_API_ALL_READ_DONE,
+  M_CFIFO_API_THIS_WRITE_DONE,
+  M_CFIFO_API_ALL_WRITE_DONE,
+  M_CFIFO_API_POOL_ACQUIRE,
+  M_CFIFO_API_POOL_RELEASE,
+  M_CFIFO_API_PRODUCER_WRITE,
+  M_CFIFO_API_PRODUCER_FLUSH,
+  M_CFIFO_API_SPSC_PUSH,
+  M_CFIFO_API_SPSC_WRITE,
+  M_CFIFO_API_SPSC_POP,
+  M_CFIFO_API_SPSC_READ,
+  M_CFIFO_API_PRODUCER_PUSH,
+  M_CFIFO_API_INIT_BUFFER,
+  M_CFIFO_API_INIT_BUFFER_STATIC,
+  M_CFIFO_API_THIS_RESIZE,
+  M_CFIFO_API_THIS_GET_STATE,
+  M_CFIFO_API_THIS_RESTORE_STATE,
+  M_CFIFO_API_SET_RELEASE_HOOK,
+  M_CFIFO_API_SHM_WRITE,
+  M_CFIFO_API_SHM_READ,
+  M_CFIFO_API_THIS_POP_BLOCK,
+  M_CFIFO_API_SET_RATE_LIMIT,
+  M_CFIFO_API_GET_RATE_LIMIT_DELAY,
+  M_CFIFO_API_THIS_FIND_PATTERN,
+  M_CFIFO_API_THIS_POP_BLOCK_TRANSFORM,
+  M_CFIFO_API_AUDIO_WRITE,
+  M_CFIFO_API_AUDIO_READ,
+  M_CFIFO_API_THIS_POP_BLOCK_WAIT,
+  M_CFIFO_API_DEQUE_PUSH,
+  M_CFIFO_API_DEQUE_POP,
+  M_CFIFO_API_DEQUE_STEAL,
+  M_CFIFO_API_SHARD_PUSH_TO,
+  M_CFIFO_API_SHARD_POP,
+  M_CFIFO_API_SET_LOCK_POLICY,
+  M_CFIFO_API_GET_LOCK_STATS,
+  M_CFIFO_API_INIT_BUFFER_LOCK,
+  M_CFIFO_API_SET_LATENCY_HISTOGRAM,
+  M_CFIFO_API_GET_LATENCY_HISTOGRAM,
+  M_CFIFO_API_THIS_GET_PEAK,
+  M_CFIFO_API_ALL_PUSH_BLOCK,
+  M_CFIFO_API_ALL_POP_BLOCK,
+  M_CFIFO_API_THIS_READ,
+  M_CFIFO_API_THIS_ACK,
+  M_CFIFO_API_THIS_REWIND,
+  M_CFIFO_API_GET_STREAM_OFFSETS,
+  M_CFIFO_API_SET_STREAM_OFFSET,
+  M_CFIFO_API_THIS_PEEK_AT,
+  M_CFIFO_API_THIS_SKIP_TO,
+  M_CFIFO_API_THIS_RESERVE,
+  M_CFIFO_API_THIS_GRANT,
+  M_CFIFO_API_THIS_COMMIT,
+  M_CFIFO_API_THIS_ABORT,
+  M_CFIFO_API_THIS_PUBLISH_GRANTS,
+  M_CFIFO_API_THIS_COMMIT_FROM_ISR
+}m_cfifo_tTraceApi;
+
+
+/**
+ * @brief One trace event as stored in the ring and in the dump.
+ *
+ * `timestamp` is in microseconds since boot; it is 64 bit so long
+ * captures do not wrap.
+ * `fifo` and `task` hold the FIFO address and the current task handle
+ * truncated to 32 bit; they only serve as identifiers. `type` is a
+ * @ref m_cfifo_tTraceType.
+ */
+typedef struct
+{
+  uint64_t timestamp;
+  uint32_t fifo;
+  uint32_t task;
+  uint16_t arg;
+  uint8_t type;
+  uint8_t core;
+}m_cfifo_tTraceEvent;
+
+
+/**
+ * @brief Header written in front of the events by @ref m_cfifo_Trace_Dump.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t event_size;
+  uint32_t event_count;
+}m_cfifo_tTraceHeader;
+
+
+/**
+ * @brief Output callback used by @ref m_cfifo_Trace_Dump.
+ *
+ * @param data   Bytes to emit.
+ * @param length Number of bytes.
+ * @param ctx    User context.
+ */
+typedef void (*m_cfifo_tTraceSink)(const void* data, size_t length, void* ctx);
+
+
+//*****************************************************************************
+// Global Function Prototypes
+//*****************************************************************************
+
+#ifdef CONFIG_M_CFIFO_TRACE
+
+/**
+ * @brief Append an event to the trace ring.
+ *
+ * Lock-free and safe to call from any task or ISR. The oldest events
+ * are overwritten once the ring is full.
+ *
+ * @param type  Event kind, see @ref m_cfifo_tTraceType.
+ * @param cfifo FIFO the event refers to (may be NULL).
+ * @param arg   Event specific argument.
+ */
+void m_cfifo_Trace_Record(m_cfifo_tTraceType type, const void* cfifo, uint16_t arg);
+
+
+/**
+ * @brief Record a task switch.
+ *
+ * Intended to be called from the FreeRTOS `traceTASK_SWITCHED_IN()` hook.
+ */
+void m_cfifo_Trace_TaskSwitchedIn(void);
+
+
+/**
+ * @brief Enable or disable recording at runtime.
+ *
+ * Recording should be paused while dumping to get a consistent snapshot.
+ *
+ * @param enable true to record events, false to pause.
+ */
+void m_cfifo_Trace_Enable(bool enable);
+
+
+/**
+ * @brief Discard all recorded events.
+ */
+void m_cfifo_Trace_Reset(void);
+
+
+/**
+ * @brief Write the trace header and all recorded events, oldest first.
+ *
+ * @param sink Output callback.
+ * @param ctx  User context handed to @p sink.
+ * @return Number of events written.
+ */
+uint32_t m_cfifo_Trace_Dump(m_cfifo_tTraceSink sink, void* ctx);
+
+#endif /* CONFIG_M_CFIFO_TRACE */
+
+
+#endif /* M_CFIFO_TRACE_H_ */
@@ -0,0 +1,190 @@
+/**
+ * @file m_cfifo_typed.h
+ * @brief Macro-generated, statically sized and typed FIFOs.
+ *
+ * @ref M_CFIFO_DECLARE emits a FIFO type for one element type and a
+ * compile-time capacity, together with `static inline` access functions.
+ * Because the capacity is a power of two known at compile time, the
+ * wrap masks are constant-folded and push/pop compile to a handful of
+ * instructions, without the runtime size and byte-width generality of
+ * m_cfifo_tCFifo.
+ *
+ * Semantics follow m_cfifo_tCFifo: push fails when full, pop fails when
+ * empty. @ref M_CFIFO_DECLARE protects every call with a FreeRTOS binary
+ * semaphore; @ref M_CFIFO_DECLARE_UNLOCKED omits it for FIFOs confined
+ * to one task.
+ *
+ * Example:
+ * @code
+ * M_CFIFO_DECLARE(sample_fifo, int16_t, 256)
+ *
+ * static sample_fifo_tFifo samples;
+ * sample_fifo_Init(&samples);
+ * sample_fifo_Push(&samples, -42);
+ * @endcode
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+#ifndef M_CFIFO_TYPED_H_
+#define M_CFIFO_TYPED_H_
+
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+//*****************************************************************************
+// Global Defines
+//*****************************************************************************
+
+#define M_CFIFO_TYPED_TIMEOUT 1000
+
+/**
+ * @brief Declare a thread-safe typed FIFO.
+ *
+ * @param name     Prefix of the generated type (`name##_tFifo`) and functions.
+ * @param type     Element type.
+ * @param capacity Number of elements; must be a power of two.
+ */
+#define M_CFIFO_DECLARE(name, type, capacity) \
+  M_CFIFO_DECLARE_EX(name, type, capacity, 1)
+
+/**
+ * @brief Declare a typed FIFO without semaphore protection.
+ *
+ * @param name     Prefix of the generated type (`name##_tFifo`) and functions.
+ * @param type     Element type.
+ * @param capacity Number of elements; must be a power of two.
+ */
+#define M_CFIFO_DECLARE_UNLOCKED(name, type, capacity) \
+  M_CFIFO_DECLARE_EX(name, type, capacity, 0)
+
+/**
+ * @brief Common generator behind @ref M_CFIFO_DECLARE and
+ *        @ref M_CFIFO_DECLARE_UNLOCKED.
+ *
+ * `rdPtr` and `wrPtr` run freely and are masked on access, so the usage
+ * is simply their difference. `locked` is a constant and the untaken
+ * branches are removed by the compiler.
+ */
+#define M_CFIFO_DECLARE_EX(name, type, capacity, locked)                           \
+  _Static_assert((capacity) > 0 && ((capacity) & ((capacity) - 1)) == 0,          \
+                 #name ": capacity must be a power of two");                      \
+                                                                                  \
+  typedef struct                                                                  \
+  {                                                                               \
+    type buffer[(capacity)];                                                      \
+    uint32_t rdPtr;                                                               \
+    uint32_t wrPtr;                                                               \
+    SemaphoreHandle_t semaphore;                                                  \
+  }name##_tFifo;                                                                  \
+                                                                                  \
+  static inline bool name##_Lock(name##_tFifo* cfifo)                             \
+  {                                                                               \
+    if (!(locked))                                                                \
+      return true;                                                                \
+    return xSemaphoreTake(cfifo->semaphore,                                       \
+                          M_CFIFO_TYPED_TIMEOUT / portTICK_PERIOD_MS) == pdTRUE;  \
+  }                                                                               \
+                                                                                  \
+  static inline void name##_Unlock(name##_tFifo* cfifo)                           \
+  {                                                                               \
+    if (locked)                                                                   \
+      xSemaphoreGive(cfifo->semaphore);                                           \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_Init(name##_tFifo* cfifo)                             \
+  {                                                                               \
+    cfifo->rdPtr = 0;                                                             \
+    cfifo->wrPtr = 0;                                                             \
+    cfifo->semaphore = NULL;                                                      \
+    if (locked)                                                                   \
+    {                                                                             \
+      cfifo->semaphore = xSemaphoreCreateBinary();                                \
+      if (cfifo->semaphore == NULL)                                               \
+        return false;                                                             \
+      xSemaphoreGive(cfifo->semaphore);                                           \
+    }                                                                             \
+    return true;                                                                  \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_Push(name##_tFifo* cfifo, type data)                  \
+  {                                                                               \
+    bool res = false;                                                             \
+    if (!name##_Lock(cfifo))                                                      \
+      return false;                                                               \
+    if (cfifo->wrPtr - cfifo->rdPtr < (uint32_t)(capacity))                       \
+    {                                                                             \
+      cfifo->buffer[cfifo->wrPtr & ((capacity) - 1)] = data;                      \
+      cfifo->wrPtr++;                                                             \
+      res = true;                                                                 \
+    }                                                                             \
+    name##_Unlock(cfifo);                                                         \
+    return res;                                                                   \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_Pop(name##_tFifo* cfifo, type* data)                  \
+  {                                                                               \
+    bool res = false;                                                             \
+    if (!name##_Lock(cfifo))                                                      \
+      return false;                                                               \
+    if (cfifo->wrPtr != cfifo->rdPtr)                                             \
+    {                                                                             \
+      *data = cfifo->buffer[cfifo->rdPtr & ((capacity) - 1)];                     \
+      cfifo->rdPtr++;                                                             \
+      res = true;                                                                 \
+    }                                                                             \
+    name##_Unlock(cfifo);                                                         \
+    return res;                                                                   \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_Clear(name##_tFifo* cfifo)                            \
+  {                                                                               \
+    if (!name##_Lock(cfifo))                                                      \
+      return false;                                                               \
+    cfifo->rdPtr = cfifo->wrPtr;                                                  \
+    name##_Unlock(cfifo);                                                         \
+    return true;                                                                  \
+  }                                                                               \
+                                                                                  \
+  static inline uint32_t name##_GetSize(name##_tFifo* cfifo)                      \
+  {                                                                               \
+    (void)cfifo;                                                                  \
+    return (capacity);                                                            \
+  }                                                                               \
+                                                                                  \
+  static inline uint32_t name##_GetUsage(name##_tFifo* cfifo)                     \
+  {                                                                               \
+    uint32_t res = 0;                                                             \
+    if (!name##_Lock(cfifo))                                                      \
+      return res;                                                                 \
+    res = cfifo->wrPtr - cfifo->rdPtr;                                            \
+    name##_Unlock(cfifo);                                                         \
+    return res;                                                                   \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_IsEmpty(name##_tFifo* cfifo)                          \
+  {                                                                               \
+    bool res;                                                                     \
+    if (!name##_Lock(cfifo))                                                      \
+      return false;                                                               \
+    res = cfifo->wrPtr == cfifo->rdPtr;                                           \
+    name##_Unlock(cfifo);                                                         \
+    return res;                                                                   \
+  }                                                                               \
+                                                                                  \
+  static inline bool name##_IsFull(name##_tFifo* cfifo)                           \
+  {                                                                               \
+    bool res;                                                                     \
+    if (!name##_Lock(cfifo))                                                      \
+      return false;                                                               \
+    res = cfifo->wrPtr - cfifo->rdPtr >= (uint32_t)(capacity);                    \
+    name##_Unlock(cfifo);                                                         \
+    return res;                                                                   \
+  }
+
+
+#endif /* M_CFIFO_TYPED_H_ */
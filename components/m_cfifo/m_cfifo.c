@@ -25,7 +25,17 @@
 
 
 #include "m_cfifo.h"
+#include "m_cfifo_trace.h"
 #include <stddef.h>
+#include <string.h>
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 
 //*****************************************************************************
@@ -33,11 +43,95 @@
 //*****************************************************************************
 #define M_CFIFO_TIMEOUT 1000
 
+// upper limit and headroom of the adaptive spin budget (attempts)
+#define M_CFIFO_SPIN_MAX 1000
+#define M_CFIFO_SPIN_MIN 16
+
+_Static_assert(M_CFIFO_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+               "CONFIG_M_CFIFO_NOTIFY_INDEX needs more CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES");
+
 
 //*****************************************************************************
 // Local Function Prototypes
 //*****************************************************************************
 
+/**
+ * @brief Acquires the FIFO semaphore on behalf of a public API function.
+ *
+ * Emits the trace events for the call and, if the semaphore is
+ * contended, for blocking and wake-up. Without CONFIG_M_CFIFO_TRACE this
+ * reduces to a plain `xSemaphoreTake`.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param api   Identifier of the calling public function.
+ *
+ * @retval true  Semaphore taken.
+ * @retval false Timeout expired.
+ */
+static inline bool m_cfifo_Lock(m_cfifo_tCFifo* cfifo, m_cfifo_tTraceApi api);
+
+
+/**
+ * @brief Releases the FIFO semaphore taken by @ref m_cfifo_Lock.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ */
+static inline void m_cfifo_Unlock(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Spins on a contended FIFO semaphore within the adaptive budget.
+ *
+ * Polls the semaphore count and only attempts to take it when it reads
+ * free. Updates the spin average and budget on success; after an
+ * exhausted spin the caller does so once it holds the lock.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ *
+ * @retval true  Semaphore taken while spinning.
+ * @retval false Policy is blocking, single core, or budget exhausted.
+ */
+static bool m_cfifo_SpinInternal(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Feeds one spin outcome into the spin average and budget.
+ *
+ * Must be called with the FIFO locked.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param spins Attempts a successful spin needed, 0 for an exhausted spin.
+ */
+#if portNUM_PROCESSORS > 1
+static void m_cfifo_SpinSampleInternal(m_cfifo_tCFifo* cfifo, uint16_t spins);
+#endif
+
+
+/**
+ * @brief Creates the semaphore and resets all fields.
+ *
+ * Shared by all init variants.
+ *
+ * @param cfifo            Pointer to the FIFO instance.
+ * @param lock_type        Lock type of the FIFO.
+ * @param semaphore_buffer Static semaphore storage, or NULL to allocate.
+ *
+ * @retval true  FIFO initialized.
+ * @retval false Invalid lock type or semaphore creation failed.
+ */
+static bool m_cfifo_InitBufferInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tLockType lock_type, StaticSemaphore_t* semaphore_buffer);
+
+
+/**
+ * @brief Sets links, dummy byte and optional policies to their defaults.
+ *
+ * Shared by all init variants; does not touch buffer or semaphore.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ */
+static void m_cfifo_InitFieldsInternal(m_cfifo_tCFifo* cfifo);
+
+
 /**
  * @brief Internal push operation for a single FIFO instance.
  *
@@ -54,6 +148,21 @@
 static bool m_cfifo_This_PushInternal(m_cfifo_tCFifo* cfifo, uint8_t data);
 
 
+/**
+ * @brief Internal block push operation for a single FIFO instance.
+ *
+ * Copies up to @p length bytes into the free space, splitting the copy
+ * at the wrap point. No semaphore protection.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param data   Source bytes.
+ * @param length Number of bytes to push.
+ *
+ * @return Number of bytes written.
+ */
+static uint16_t m_cfifo_This_PushBlockInternal(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length);
+
+
 /**
  * @brief Internal pop operation for a single FIFO instance.
  *
@@ -69,6 +178,115 @@ static bool m_cfifo_This_PushInternal(m_cfifo_tCFifo* cfifo, uint8_t data);
 static bool m_cfifo_This_PopInternal(m_cfifo_tCFifo* cfifo, uint8_t* data);
 
 
+/**
+ * @brief Internal block pop operation for a single FIFO instance.
+ *
+ * Copies up to @p length bytes out of the FIFO, splitting the copy at
+ * the wrap point and applying @p transform on the way. For byte swap
+ * transforms @p length is rounded down to whole words. No semaphore
+ * protection, no rate limiting.
+ *
+ * @param cfifo     Pointer to the FIFO instance.
+ * @param data      Destination buffer.
+ * @param length    Maximum number of bytes to pop.
+ * @param transform Transform to apply.
+ * @param mask      XOR mask.
+ *
+ * @return Number of bytes read.
+ */
+static uint16_t m_cfifo_This_PopBlockInternal(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, m_cfifo_tTransform transform, uint8_t mask);
+
+
+/**
+ * @brief Copies stored bytes without consuming them.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param skip   Number of stored bytes to skip, counted from `rdPtr`.
+ * @param data   Destination buffer.
+ * @param length Maximum number of bytes.
+ *
+ * @return Number of bytes copied.
+ */
+static uint16_t m_cfifo_This_PeekInternal(m_cfifo_tCFifo* cfifo, uint16_t skip, uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Copies a contiguous region while applying a transform.
+ *
+ * @param dst       Destination.
+ * @param src       Source.
+ * @param length    Number of bytes, a multiple of the transform word size.
+ * @param transform Transform to apply.
+ * @param mask      XOR mask.
+ */
+static void m_cfifo_TransformCopy(uint8_t* dst, const uint8_t* src, uint16_t length, m_cfifo_tTransform transform, uint8_t mask);
+
+
+/**
+ * @brief Word size a transform operates on.
+ *
+ * @param transform Transform.
+ * @return 1, 2 or 4.
+ */
+static uint8_t m_cfifo_TransformWidth(m_cfifo_tTransform transform);
+
+
+/**
+ * @brief Number of bytes the rate limiter currently allows to pop.
+ *
+ * Refills the token bucket for the elapsed time first.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return Allowed bytes, UINT32_MAX if no rate limit is attached.
+ */
+static uint32_t m_cfifo_RateLimitAvailable(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Charges popped bytes to the rate limiter.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param length Number of popped bytes.
+ */
+static void m_cfifo_RateLimitConsume(m_cfifo_tCFifo* cfifo, uint32_t length);
+
+
+/**
+ * @brief Ticks until the rate limiter releases the next byte.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return Ticks to wait, 0 if bytes may be popped now or no limit is attached.
+ */
+static TickType_t m_cfifo_RateLimitDelay(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Hands pushed bytes directly to a waiting consumer.
+ *
+ * If a consumer waits and the FIFO is empty, copies up to its buffer
+ * length from @p data into the consumer's buffer. A registered consumer
+ * is always unregistered and woken, so it can pop bytes that went into
+ * the ring instead.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param data   Pushed bytes.
+ * @param length Number of pushed bytes.
+ *
+ * @return Number of bytes handed off; the rest goes into the ring.
+ */
+static uint16_t m_cfifo_HandoffInternal(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length);
+
+
+/**
+ * @brief Unregisters and wakes a consumer waiting in @ref m_cfifo_This_PopBlockWait.
+ *
+ * The consumer pops whatever the ring holds once it runs again.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ */
+static void m_cfifo_WakeWaiterInternal(m_cfifo_tCFifo* cfifo);
+
+
 /**
  * @brief Internal reset of FIFO read/write state.
  *
@@ -134,7 +352,8 @@ static bool m_cfifo_This_IsFullInternal(m_cfifo_tCFifo* cfifo);
 /**
  * @brief Advances the read pointer of the FIFO.
  *
- * Increments the read index and wraps using modulo `buffer_size`.
+ * Increments the read index and wraps at the end of the buffer or at
+ * the start of a wrap gap, which is released then.
  * Intended only for use inside internal FIFO operations.
  *
  * @param cfifo Pointer to the FIFO instance.
@@ -167,6 +386,171 @@ static void m_cfifo_IncWrPtr(m_cfifo_tCFifo* cfifo);
 static m_cfifo_tCFifo* m_cfifo_GetAdjacentFifo(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction);
 
 
+/**
+ * @brief Internal getter for the number of free bytes.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @return Number of bytes that can still be written.
+ */
+static uint16_t m_cfifo_This_GetFreeInternal(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Internal export of the stored bytes as contiguous regions.
+ *
+ * Produces at most two descriptors: from `rdPtr` up to the end of the
+ * buffer (or the start of a wrap gap), and the wrapped remainder
+ * starting at offset 0.
+ *
+ * @param cfifo    Pointer to the FIFO instance.
+ * @param desc     Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+static uint8_t m_cfifo_This_GetReadDescriptorsInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Internal export of the free space as contiguous regions.
+ *
+ * Produces at most two descriptors: from `wrPtr` up to the end of the
+ * buffer, and the wrapped remainder starting at offset 0.
+ *
+ * @param cfifo    Pointer to the FIFO instance.
+ * @param desc     Array receiving the descriptors.
+ * @param max_desc Number of entries available in @p desc.
+ * @return Number of descriptors written.
+ */
+static uint8_t m_cfifo_This_GetWriteDescriptorsInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc);
+
+
+/**
+ * @brief Releases stored bytes by advancing the read pointer.
+ *
+ * The caller must ensure @p length does not exceed the usage. Releases
+ * the wrap gap once the read pointer passes it.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param length Number of bytes to release.
+ */
+static void m_cfifo_This_ReadDoneInternal(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Publishes written bytes by advancing the write pointer.
+ *
+ * The caller must ensure @p length does not exceed the free space.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param length Number of bytes to publish.
+ */
+static void m_cfifo_This_WriteDoneInternal(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Accounts bytes that entered the FIFO.
+ *
+ * Central hook for every write path: emits the trace event, wakes a
+ * consumer waiting in @ref m_cfifo_This_PopBlockWait and arms a
+ * residence time sample. Call after `used_count` has been increased.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param length Number of written bytes.
+ */
+static void m_cfifo_OnWrittenInternal(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Accounts bytes that left the FIFO.
+ *
+ * Central hook for every read path: emits the trace event and completes
+ * a pending residence time sample.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param length Number of read bytes.
+ */
+static void m_cfifo_OnReadInternal(m_cfifo_tCFifo* cfifo, uint16_t length);
+
+
+/**
+ * @brief Drops a pending residence time sample after the content was discarded.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ */
+static void m_cfifo_OnResetInternal(m_cfifo_tCFifo* cfifo);
+
+
+/**
+ * @brief Calls the release hook with the current state, if one is attached.
+ *
+ * @param cfifo    Pointer to the FIFO instance.
+ * @param released Number of bytes released, 0 for a reset.
+ */
+static void m_cfifo_OnReleasedInternal(m_cfifo_tCFifo* cfifo, uint16_t released);
+
+
+/**
+ * @brief Fills a state snapshot. No semaphore protection.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ * @param state Destination of the snapshot.
+ */
+static void m_cfifo_This_GetStateInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tState* state);
+
+
+/**
+ * @brief Finds the first occurrence of a byte in a memory region.
+ *
+ * Compares 16 bytes per step with SSE2 or NEON where available, and
+ * four bytes per aligned word load otherwise (Xtensa, RISC-V).
+ *
+ * @param data   Start of the region.
+ * @param length Length of the region.
+ * @param value  Byte to search for.
+ * @return Index of the first match, @p length if not found.
+ */
+static uint16_t m_cfifo_FindByte(const uint8_t* data, uint16_t length, uint8_t value);
+
+
+/**
+ * @brief Compares a pattern against the stored bytes at a logical offset.
+ *
+ * Handles patterns that straddle the wrap point.
+ *
+ * @param desc    Read descriptors of the FIFO.
+ * @param offset  Offset relative to the read pointer.
+ * @param pattern Pattern bytes.
+ * @param length  Pattern length.
+ * @return true if the pattern matches.
+ */
+static bool m_cfifo_MatchAt(const m_cfifo_tDescriptor* desc, uint16_t offset, const uint8_t* pattern, uint16_t length);
+
+
+/**
+ * @brief Marks an outstanding grant as completed.
+ *
+ * Must be called inside the grant critical section. Only the newest
+ * grant may complete with fewer bytes than granted.
+ *
+ * @param cfifo    Pointer to the FIFO instance.
+ * @param grant_id Id of the grant.
+ * @param length   Number of bytes written into the region.
+ * @return true if the grant was marked, false if the id or length is invalid.
+ */
+static bool m_cfifo_CompleteGrantInternal(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length);
+
+
+/**
+ * @brief Publishes the completed grants at the head of the grant list.
+ *
+ * Must be called with the FIFO locked, outside the grant critical
+ * section.
+ *
+ * @param cfifo Pointer to the FIFO instance.
+ */
+static void m_cfifo_PublishGrantsInternal(m_cfifo_tCFifo* cfifo);
+
+
 
 //*****************************************************************************
 // Global Functions
@@ -174,15 +558,66 @@ static m_cfifo_tCFifo* m_cfifo_GetAdjacentFifo(m_cfifo_tCFifo* cfifo, m_cfifo_tD
 
 bool m_cfifo_InitBuffer(m_cfifo_tCFifo* cfifo)
 {
-  cfifo->semaphore = xSemaphoreCreateBinary();
-  if (cfifo->semaphore == NULL)
+  if (!cfifo)
     return false;
 
-  cfifo->prev = NULL;
-  cfifo->next = NULL;
-  cfifo->dummy_byte = 0x00;
-  m_cfifo_ConfigBuffer(cfifo, NULL, 0);
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, cfifo, M_CFIFO_API_INIT_BUFFER);
+  return m_cfifo_InitBufferInternal(cfifo, M_CFIFO_LOCK_TYPE_BINARY, NULL);
+}
+
+bool m_cfifo_InitBufferStatic(m_cfifo_tCFifo* cfifo, StaticSemaphore_t* semaphore_buffer)
+{
+  if (!cfifo || !semaphore_buffer)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, cfifo, M_CFIFO_API_INIT_BUFFER_STATIC);
+  return m_cfifo_InitBufferInternal(cfifo, M_CFIFO_LOCK_TYPE_BINARY, semaphore_buffer);
+}
+
+bool m_cfifo_InitBufferLock(m_cfifo_tCFifo* cfifo, m_cfifo_tLockType lock_type, StaticSemaphore_t* semaphore_buffer)
+{
+  if (!cfifo)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, cfifo, M_CFIFO_API_INIT_BUFFER_LOCK);
+  return m_cfifo_InitBufferInternal(cfifo, lock_type, semaphore_buffer);
+}
+
+bool m_cfifo_SetLockPolicy(m_cfifo_tCFifo* cfifo, m_cfifo_tLockPolicy policy)
+{
+  if (!cfifo || policy > M_CFIFO_LOCK_ADAPTIVE)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_LOCK_POLICY))
+    return false;
+
+  cfifo->lock_policy            = policy;
+  cfifo->lock_stats.spin_avg    = 0;
+  cfifo->lock_stats.spin_budget = M_CFIFO_SPIN_MIN;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_GetLockStats(m_cfifo_tCFifo* cfifo, m_cfifo_tLockStats* stats, bool reset)
+{
+  if (!cfifo || !stats)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_GET_LOCK_STATS))
+    return false;
 
+  *stats = cfifo->lock_stats;
+
+  if (reset)
+  {
+    cfifo->lock_stats.acquisitions  = 0;
+    cfifo->lock_stats.contended     = 0;
+    cfifo->lock_stats.spin_acquired = 0;
+    cfifo->lock_stats.blocked       = 0;
+  }
+
+  m_cfifo_Unlock(cfifo);
   return true;
 }
 
@@ -191,13 +626,13 @@ bool m_cfifo_CascadeAsNextBuffer(m_cfifo_tCFifo* cfifo, m_cfifo_tCFifo* cfifo_ne
   if (!cfifo || !cfifo_next)
     return false;
   
-    if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_CASCADE_AS_NEXT_BUFFER))
     return false;
 
   cfifo->next        = cfifo_next;
   cfifo_next->prev   = cfifo;
   
-  xSemaphoreGive(cfifo->semaphore);
+  m_cfifo_Unlock(cfifo);
 
   return true;
 }
@@ -207,13 +642,19 @@ bool m_cfifo_ConfigBuffer(m_cfifo_tCFifo* cfifo, const void* buffer, uint16_t bu
   if (!cfifo)
     return false;
   
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_CONFIG_BUFFER))
     return false;
 
   cfifo->buffer      = (uint8_t*)buffer;
   cfifo->buffer_size = buffer_size;
   m_cfifo_This_SetFullInternal(cfifo);
-  xSemaphoreGive(cfifo->semaphore);
+
+  // restart the stream at 0, the fill counts as written like a set-full
+  cfifo->rd_total = 0;
+  cfifo->wr_total = cfifo->used_count;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
 }
 
 bool m_cfifo_SetDummyByte(m_cfifo_tCFifo* cfifo, uint8_t data)
@@ -221,415 +662,2211 @@ bool m_cfifo_SetDummyByte(m_cfifo_tCFifo* cfifo, uint8_t data)
   if (!cfifo)
     return false;
   
-    if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_DUMMY_BYTE))
     return false;
   cfifo->dummy_byte = data;
-  xSemaphoreGive(cfifo->semaphore);
+  m_cfifo_Unlock(cfifo);
+  return true;
 }  
 
-bool m_cfifo_This_Push(m_cfifo_tCFifo* cfifo, uint8_t data)
+bool m_cfifo_This_Resize(m_cfifo_tCFifo* cfifo, const void* buffer, uint16_t buffer_size)
 {
-  bool res;
+  m_cfifo_tDescriptor desc[2];
+  uint8_t desc_count;
+  uint16_t copied = 0;
 
-  if (!cfifo)
+  if (!cfifo || !buffer || buffer_size == 0)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_RESIZE))
+    return false;
+
+  if (m_cfifo_This_GetUsageInternal(cfifo) > buffer_size || cfifo->grant_count > 0)
+  {
+    m_cfifo_Unlock(cfifo);
     return false;
+  }
 
-    res = m_cfifo_This_PushInternal(cfifo, data);
+  desc_count = m_cfifo_This_GetReadDescriptorsInternal(cfifo, desc, 2);
 
-    xSemaphoreGive(cfifo->semaphore);
-    return res;
+  for (uint8_t i = 0; i < desc_count; i++)
+  {
+    memcpy((uint8_t*)buffer + copied, desc[i].address, desc[i].length);
+    copied += desc[i].length;
+  }
+
+  cfifo->buffer      = (uint8_t*)buffer;
+  cfifo->buffer_size = buffer_size;
+  cfifo->rdPtr       = 0;
+  cfifo->wrPtr       = cfifo->used_count % buffer_size;
+  cfifo->wrap_gap    = 0;
+
+  // a peak from the larger buffer cannot be reached any more
+  if (cfifo->peak_count > buffer_size)
+    cfifo->peak_count = buffer_size;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
 }
 
-bool m_cfifo_All_Push(m_cfifo_tCFifo* cfifo, uint8_t data)
+uint16_t m_cfifo_This_GetPeak(m_cfifo_tCFifo* cfifo, bool reset)
 {
-  bool success;
+  uint16_t peak;
 
   if (!cfifo)
+    return 0;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_PEAK))
+    return 0;
+
+  peak = cfifo->peak_count;
+
+  if (reset)
+    cfifo->peak_count = cfifo->used_count;
+
+  m_cfifo_Unlock(cfifo);
+  return peak;
+}
+
+bool m_cfifo_This_GetState(m_cfifo_tCFifo* cfifo, m_cfifo_tState* state)
+{
+  if (!cfifo || !state)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_STATE))
     return false;
 
-  m_cfifo_tCFifo* actual_buffer = cfifo;
-  success = false;
-  
-  while (!success && actual_buffer != NULL)
+  m_cfifo_This_GetStateInternal(cfifo, state);
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_This_RestoreState(m_cfifo_tCFifo* cfifo, const m_cfifo_tState* state)
+{
+  bool res = false;
+
+  if (!cfifo || !state)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_RESTORE_STATE))
+    return false;
+
+  // a gap lies between the stored bytes at the end and the wrapped ones
+  if (state->buffer_size == cfifo->buffer_size &&
+      state->buffer_size != 0 &&
+      (uint32_t)state->used_count + state->wrap_gap <= state->buffer_size &&
+      state->rdPtr < state->buffer_size - state->wrap_gap &&
+      (state->wrap_gap == 0 ||
+       (uint32_t)state->rdPtr + state->used_count >= (uint32_t)state->buffer_size - state->wrap_gap) &&
+      state->wrPtr == ((uint32_t)state->rdPtr + state->used_count + state->wrap_gap) % state->buffer_size)
   {
-    success = m_cfifo_This_PushInternal(actual_buffer, data);
-    actual_buffer = actual_buffer->next;
+    cfifo->used_count = state->used_count;
+    cfifo->rdPtr      = state->rdPtr;
+    cfifo->wrPtr      = state->wrPtr;
+    cfifo->wrap_gap   = state->wrap_gap;
+    cfifo->grant_count = 0;
+    cfifo->rd_total   = cfifo->wr_total - cfifo->used_count;
+    m_cfifo_OnResetInternal(cfifo);
+    res = true;
   }
-  
-  xSemaphoreGive(cfifo->semaphore);
-  return success;
+
+  m_cfifo_Unlock(cfifo);
+  return res;
 }
 
-bool m_cfifo_This_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data)
+bool m_cfifo_This_Push(m_cfifo_tCFifo* cfifo, uint8_t data)
 {
   bool res;
-  
-  if (!cfifo || !data)
+
+  if (!cfifo)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_PUSH))
     return false;
 
-  res = m_cfifo_This_PopInternal(cfifo, data);
+  res = m_cfifo_HandoffInternal(cfifo, &data, 1) == 1 || m_cfifo_This_PushInternal(cfifo, data);
 
-  xSemaphoreGive(cfifo->semaphore);
+  m_cfifo_Unlock(cfifo);
   return res;
 }
 
-bool m_cfifo_All_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data)
+uint16_t m_cfifo_This_PushBlock(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length)
 {
-  bool success;
-  
+  uint16_t res = 0;
+
   if (!cfifo || !data)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_PUSH_BLOCK))
+    return res;
+
+  res = m_cfifo_HandoffInternal(cfifo, data, length);
+  res += m_cfifo_This_PushBlockInternal(cfifo, &data[res], length - res);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_All_Push(m_cfifo_tCFifo* cfifo, uint8_t data)
+{
+  bool success;
+
+  if (!cfifo)
     return false;
   
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_PUSH))
     return false;
 
   m_cfifo_tCFifo* actual_buffer = cfifo;
-  success = false;
+  success = m_cfifo_HandoffInternal(cfifo, &data, 1) == 1;
   
   while (!success && actual_buffer != NULL)
   {
-    success = m_cfifo_This_PopInternal(actual_buffer, data);
+    success = m_cfifo_This_PushInternal(actual_buffer, data);
     actual_buffer = actual_buffer->next;
   }
-
-  xSemaphoreGive(cfifo->semaphore);
+  
+  m_cfifo_Unlock(cfifo);
   return success;
 }
 
-bool m_cfifo_This_Clear(m_cfifo_tCFifo* cfifo)
+uint32_t m_cfifo_All_PushBlock(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint32_t length)
 {
-  if (!cfifo)
-    return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return false;
-  
-  m_cfifo_This_ClearInternal(cfifo);
+  uint32_t res = 0;
 
-  xSemaphoreGive(cfifo->semaphore);
-  return true;
-}
+  if (!cfifo || !data)
+    return res;
 
-bool m_cfifo_All_Clear(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
-{
-    m_cfifo_tCFifo* actual_buffer = cfifo;
-    
-  if (!cfifo)
-    return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return false;
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_PUSH_BLOCK))
+    return res;
 
-  while (actual_buffer != NULL)
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+  res = m_cfifo_HandoffInternal(cfifo, data, length > UINT16_MAX ? UINT16_MAX : (uint16_t)length);
+
+  while (res < length && actual_buffer != NULL)
   {
-    m_cfifo_This_ClearInternal(actual_buffer);
-    actual_buffer = m_cfifo_GetAdjacentFifo(actual_buffer, direction);
+    uint32_t chunk = length - res;
+
+    if (chunk > UINT16_MAX)
+      chunk = UINT16_MAX;
+
+    res += m_cfifo_This_PushBlockInternal(actual_buffer, &data[res], (uint16_t)chunk);
+
+    // stay on a segment until it is full, like m_cfifo_All_Push does
+    if (m_cfifo_This_GetFreeInternal(actual_buffer) == 0)
+      actual_buffer = actual_buffer->next;
   }
 
-  xSemaphoreGive(cfifo->semaphore);
-  return true;
+  m_cfifo_Unlock(cfifo);
+  return res;
 }
 
-bool m_cfifo_This_SetFull(m_cfifo_tCFifo* cfifo)
+bool m_cfifo_This_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data)
 {
-  if (!cfifo)
+  bool res;
+  
+  if (!cfifo || !data)
     return false;
   
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_POP))
     return false;
 
-  m_cfifo_This_SetFullInternal(cfifo);
-  
-  xSemaphoreGive(cfifo->semaphore);
-  return true;
+  res = m_cfifo_RateLimitAvailable(cfifo) > 0 && m_cfifo_This_PopInternal(cfifo, data);
+
+  if (res)
+    m_cfifo_RateLimitConsume(cfifo, 1);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
 }
 
-bool m_cfifo_All_SetFull(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
+uint16_t m_cfifo_This_PopBlock(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length)
 {
-    m_cfifo_tCFifo* actual_buffer = cfifo;
+  uint16_t res = 0;
+  uint32_t allowed;
 
-  if (!cfifo)
-    return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return false;
+  if (!cfifo || !data)
+    return res;
 
-  while (actual_buffer != NULL)
-  {
-    m_cfifo_This_SetFullInternal(actual_buffer);
-    actual_buffer = m_cfifo_GetAdjacentFifo(actual_buffer, direction);
-  }
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_POP_BLOCK))
+    return res;
 
-  xSemaphoreGive(cfifo->semaphore);
-  return true;
+  allowed = m_cfifo_RateLimitAvailable(cfifo);
+
+  if (length > allowed)
+    length = (uint16_t)allowed;
+
+  res = m_cfifo_This_PopBlockInternal(cfifo, data, length, M_CFIFO_TRANSFORM_NONE, 0);
+  m_cfifo_RateLimitConsume(cfifo, res);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
 }
 
-uint16_t m_cfifo_This_GetSize(m_cfifo_tCFifo* cfifo)
+uint16_t m_cfifo_This_PopBlockTransform(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, m_cfifo_tTransform transform, uint8_t mask)
 {
   uint16_t res = 0;
-  
-  if (!cfifo)
+  uint32_t allowed;
+
+  if (!cfifo || !data || transform > M_CFIFO_TRANSFORM_BSWAP32)
     return res;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_POP_BLOCK_TRANSFORM))
     return res;
 
-  res = m_cfifo_This_GetSizeInternal(cfifo);
-  
-  xSemaphoreGive(cfifo->semaphore);
+  allowed = m_cfifo_RateLimitAvailable(cfifo);
+
+  if (length > allowed)
+    length = (uint16_t)allowed;
+
+  res = m_cfifo_This_PopBlockInternal(cfifo, data, length, transform, mask);
+  m_cfifo_RateLimitConsume(cfifo, res);
+
+  m_cfifo_Unlock(cfifo);
   return res;
 }
 
-uint32_t m_cfifo_All_GetSize(m_cfifo_tCFifo* cfifo)
+uint16_t m_cfifo_This_PopBlockWait(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, TickType_t timeout)
 {
-  uint32_t size_total = 0;
-  
-  if (!cfifo)
-    return size_total;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return size_total;
-
-  size_total = 0;
-  m_cfifo_tCFifo* actual_buffer = cfifo;
- 
-  while (actual_buffer != NULL)
+  m_cfifo_tWaiter waiter;
+  TickType_t start = xTaskGetTickCount();
+  TickType_t elapsed;
+  TickType_t wait;
+  uint32_t allowed;
+  uint32_t notified;
+  uint16_t res;
+
+  if (!cfifo || !data || length == 0)
+    return 0;
+
+  for (;;)
   {
-    size_total += m_cfifo_This_GetSizeInternal(actual_buffer);
-    actual_buffer = actual_buffer->next;
+    if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT))
+      return 0;
+
+    allowed = m_cfifo_RateLimitAvailable(cfifo);
+    res = m_cfifo_This_PopBlockInternal(cfifo, data, length > allowed ? (uint16_t)allowed : length, M_CFIFO_TRANSFORM_NONE, 0);
+    m_cfifo_RateLimitConsume(cfifo, res);
+
+    elapsed = xTaskGetTickCount() - start;
+
+    if (res > 0 || cfifo->waiter != NULL || elapsed >= timeout)
+    {
+      m_cfifo_Unlock(cfifo);
+      return res;
+    }
+
+    wait = timeout == portMAX_DELAY ? portMAX_DELAY : timeout - elapsed;
+
+    // rate limited with data in the ring: sleep only until the next refill
+    if (allowed == 0 && cfifo->used_count > 0 && m_cfifo_RateLimitDelay(cfifo) < wait)
+      wait = m_cfifo_RateLimitDelay(cfifo);
+
+    waiter.task     = xTaskGetCurrentTaskHandle();
+    waiter.data     = data;
+    waiter.length   = length;
+    waiter.received = 0;
+    cfifo->waiter   = &waiter;
+
+    m_cfifo_Unlock(cfifo);
+
+    M_CFIFO_TRACE(M_CFIFO_TRACE_BLOCK, cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT);
+    notified = ulTaskNotifyTakeIndexed(M_CFIFO_NOTIFY_INDEX, pdTRUE, wait);
+    M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT);
+
+    // waiter lives on this stack, it must be unregistered before returning
+    while (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT))
+      ;
+
+    if (cfifo->waiter == &waiter)
+      cfifo->waiter = NULL;
+    else if (notified == 0)
+      ulTaskNotifyTakeIndexed(M_CFIFO_NOTIFY_INDEX, pdTRUE, 0);   // consume the notification that raced the timeout
+
+    m_cfifo_Unlock(cfifo);
+
+    if (waiter.received > 0)
+      return waiter.received;
   }
-  
-  xSemaphoreGive(cfifo->semaphore);
-  return size_total;
 }
 
-uint16_t m_cfifo_This_GetUsage(m_cfifo_tCFifo* cfifo)
+uint16_t m_cfifo_This_Read(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length)
 {
   uint16_t res = 0;
+  uint32_t allowed;
 
-  if (!cfifo)
+  if (!cfifo || !data)
     return res;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_READ))
     return res;
 
-  res = m_cfifo_This_GetUsageInternal(cfifo);
+  allowed = m_cfifo_RateLimitAvailable(cfifo);
 
-  xSemaphoreGive(cfifo->semaphore);
+  if (length > allowed)
+    length = (uint16_t)allowed;
+
+  res = m_cfifo_This_PeekInternal(cfifo, cfifo->sent_count, data, length);
+
+  cfifo->sent_count += res;
+  m_cfifo_RateLimitConsume(cfifo, res);
+
+  m_cfifo_Unlock(cfifo);
   return res;
 }
 
-uint32_t m_cfifo_All_GetUsage(m_cfifo_tCFifo* cfifo)
+bool m_cfifo_This_Ack(m_cfifo_tCFifo* cfifo, uint16_t length)
 {
-  uint32_t total_used = 0;
-  
+  bool res = false;
+
   if (!cfifo)
-    return total_used;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return total_used;
+    return res;
 
-  m_cfifo_tCFifo* actual_buffer = cfifo;
-  total_used = 0;
-  
-  while(actual_buffer != NULL)
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_ACK))
+    return res;
+
+  if (length <= cfifo->sent_count)
   {
-    total_used += m_cfifo_This_GetUsageInternal(actual_buffer);
-    actual_buffer = actual_buffer->next;
+    // also takes the bytes off the send cursor, see m_cfifo_OnReadInternal
+    m_cfifo_This_ReadDoneInternal(cfifo, length);
+    res = true;
   }
 
-  xSemaphoreGive(cfifo->semaphore);
-  return total_used;
+  m_cfifo_Unlock(cfifo);
+  return res;
 }
 
-bool m_cfifo_This_IsEmpty(m_cfifo_tCFifo* cfifo)
+bool m_cfifo_This_Rewind(m_cfifo_tCFifo* cfifo)
 {
-    bool res;
-
   if (!cfifo)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_REWIND))
     return false;
 
-  res = m_cfifo_This_IsEmptyInternal(cfifo);
+  cfifo->sent_count = 0;
 
-  xSemaphoreGive(cfifo->semaphore);
-  return res;
+  m_cfifo_Unlock(cfifo);
+  return true;
 }
 
-bool m_cfifo_All_IsEmpty(m_cfifo_tCFifo* cfifo)
+bool m_cfifo_GetStreamOffsets(m_cfifo_tCFifo* cfifo, uint64_t* rd_offset, uint64_t* wr_offset)
 {
-  bool is_empty = true;
-
   if (!cfifo)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_GET_STREAM_OFFSETS))
     return false;
 
-  m_cfifo_tCFifo* actual_buffer = cfifo;
-  
-  while (actual_buffer != NULL)
-  {
-    is_empty = is_empty && m_cfifo_This_IsEmptyInternal(actual_buffer);
-    actual_buffer = actual_buffer->next;
-  }
+  if (rd_offset)
+    *rd_offset = cfifo->rd_total;
 
-  xSemaphoreGive(cfifo->semaphore);
-  return is_empty;
+  if (wr_offset)
+    *wr_offset = cfifo->wr_total;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
 }
 
-bool m_cfifo_This_IsFull(m_cfifo_tCFifo* cfifo)
+bool m_cfifo_SetStreamOffset(m_cfifo_tCFifo* cfifo, uint64_t rd_offset)
 {
-    bool res;
   if (!cfifo)
     return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_STREAM_OFFSET))
     return false;
 
-  res = m_cfifo_This_IsFullInternal(cfifo);
-    
-  xSemaphoreGive(cfifo->semaphore);
-  return res;
+  cfifo->rd_total = rd_offset;
+  cfifo->wr_total = rd_offset + cfifo->used_count;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
 }
 
-bool m_cfifo_All_IsFull(m_cfifo_tCFifo* cfifo)
+uint16_t m_cfifo_This_PeekAt(m_cfifo_tCFifo* cfifo, uint64_t offset, uint8_t* data, uint16_t length)
 {
-  bool is_full = true;
+  uint16_t res = 0;
 
-  m_cfifo_tCFifo* actual_buffer = cfifo;
+  if (!cfifo || !data)
+    return res;
 
-  if (!cfifo)
-    return false;
-  
-  if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
-    return false;
-  
-  while (actual_buffer != NULL)
-  {
-    is_full = is_full && m_cfifo_This_IsFullInternal(actual_buffer);
-    actual_buffer = actual_buffer->next;
-  }
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_PEEK_AT))
+    return res;
 
-  xSemaphoreGive(cfifo->semaphore);
-  return is_full;
+  if (offset - cfifo->rd_total < cfifo->used_count)
+    res = m_cfifo_This_PeekInternal(cfifo, (uint16_t)(offset - cfifo->rd_total), data, length);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_This_SkipTo(m_cfifo_tCFifo* cfifo, uint64_t offset)
+{
+  bool res = false;
+
+  if (!cfifo)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_SKIP_TO))
+    return res;
+
+  if (offset - cfifo->rd_total <= cfifo->used_count)
+  {
+    m_cfifo_This_ReadDoneInternal(cfifo, (uint16_t)(offset - cfifo->rd_total));
+    res = true;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_SetRateLimit(m_cfifo_tCFifo* cfifo, m_cfifo_tRateLimit* limit, uint32_t bytes_per_interval, TickType_t interval, uint32_t burst)
+{
+  if (!cfifo)
+    return false;
+
+  if (limit != NULL && (bytes_per_interval == 0 || interval == 0 || burst == 0))
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_RATE_LIMIT))
+    return false;
+
+  if (limit != NULL)
+  {
+    limit->bytes_per_interval = bytes_per_interval;
+    limit->interval           = interval;
+    limit->burst              = burst;
+    limit->tokens             = burst;
+    limit->last_refill        = xTaskGetTickCount();
+  }
+
+  cfifo->rate_limit = limit;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+TickType_t m_cfifo_GetRateLimitDelay(m_cfifo_tCFifo* cfifo)
+{
+  TickType_t delay = 0;
+
+  if (!cfifo)
+    return delay;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_GET_RATE_LIMIT_DELAY))
+    return delay;
+
+  delay = m_cfifo_RateLimitDelay(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return delay;
+}
+
+bool m_cfifo_SetLatencyHistogram(m_cfifo_tCFifo* cfifo, m_cfifo_tLatency* latency, uint32_t every)
+{
+  if (!cfifo || (latency != NULL && every == 0))
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_LATENCY_HISTOGRAM))
+    return false;
+
+  if (latency != NULL)
+  {
+    memset(latency, 0, sizeof(*latency));
+    latency->every     = every;
+    latency->countdown = every;
+  }
+
+  cfifo->latency = latency;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_SetReleaseHook(m_cfifo_tCFifo* cfifo, m_cfifo_tReleaseHook hook, void* arg)
+{
+  if (!cfifo)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_SET_RELEASE_HOOK))
+    return false;
+
+  cfifo->release_hook = hook;
+  cfifo->release_arg  = arg;
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_GetLatencyHistogram(m_cfifo_tCFifo* cfifo, m_cfifo_tLatency* copy, bool reset)
+{
+  m_cfifo_tLatency* latency;
+
+  if (!cfifo || !copy)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_GET_LATENCY_HISTOGRAM))
+    return false;
+
+  latency = cfifo->latency;
+
+  if (latency != NULL)
+  {
+    *copy = *latency;
+
+    if (reset)
+    {
+      latency->samples = 0;
+      latency->skipped = 0;
+      latency->max_us  = 0;
+      memset(latency->buckets, 0, sizeof(latency->buckets));
+    }
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return latency != NULL;
+}
+
+bool m_cfifo_This_FindPattern(m_cfifo_tCFifo* cfifo, const uint8_t* pattern, uint16_t length, uint16_t* offset)
+{
+  m_cfifo_tDescriptor desc[2] = {{NULL, 0}, {NULL, 0}};
+  uint16_t used;
+  uint16_t last;
+  uint16_t pos = 0;
+  bool found = false;
+
+  if (!cfifo || !pattern || !offset || length == 0)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_FIND_PATTERN))
+    return false;
+
+  m_cfifo_This_GetReadDescriptorsInternal(cfifo, desc, 2);
+  used = desc[0].length + desc[1].length;
+
+  if (length <= used)
+  {
+    last = used - length;
+
+    while (!found && pos <= last)
+    {
+      // find the next candidate for the first byte, then verify the rest
+      if (pos < desc[0].length)
+        pos += m_cfifo_FindByte(&desc[0].address[pos], desc[0].length - pos, pattern[0]);
+      else
+        pos += m_cfifo_FindByte(&desc[1].address[pos - desc[0].length], used - pos, pattern[0]);
+
+      if (pos > last)
+        break;
+
+      found = m_cfifo_MatchAt(desc, pos, pattern, length);
+
+      if (!found)
+        pos++;
+    }
+  }
+
+  if (found)
+    *offset = pos;
+
+  m_cfifo_Unlock(cfifo);
+  return found;
+}
+
+bool m_cfifo_All_Pop(m_cfifo_tCFifo* cfifo, uint8_t* data)
+{
+  bool success;
+  
+  if (!cfifo || !data)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_POP))
+    return false;
+
+  m_cfifo_tCFifo* actual_buffer = m_cfifo_RateLimitAvailable(cfifo) > 0 ? cfifo : NULL;
+  success = false;
+  
+  while (!success && actual_buffer != NULL)
+  {
+    success = m_cfifo_This_PopInternal(actual_buffer, data);
+    actual_buffer = actual_buffer->next;
+  }
+
+  if (success)
+    m_cfifo_RateLimitConsume(cfifo, 1);
+
+  m_cfifo_Unlock(cfifo);
+  return success;
+}
+
+uint32_t m_cfifo_All_PopBlock(m_cfifo_tCFifo* cfifo, uint8_t* data, uint32_t length)
+{
+  uint32_t res = 0;
+  uint32_t allowed;
+
+  if (!cfifo || !data)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_POP_BLOCK))
+    return res;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+  allowed = m_cfifo_RateLimitAvailable(cfifo);
+
+  if (length > allowed)
+    length = allowed;
+
+  while (res < length && actual_buffer != NULL)
+  {
+    uint32_t chunk = length - res;
+
+    if (chunk > UINT16_MAX)
+      chunk = UINT16_MAX;
+
+    res += m_cfifo_This_PopBlockInternal(actual_buffer, &data[res], (uint16_t)chunk, M_CFIFO_TRANSFORM_NONE, 0);
+
+    if (m_cfifo_This_IsEmptyInternal(actual_buffer))
+      actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_RateLimitConsume(cfifo, res);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_This_Clear(m_cfifo_tCFifo* cfifo)
+{
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_CLEAR))
+    return false;
+  
+  m_cfifo_This_ClearInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_All_Clear(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
+{
+    m_cfifo_tCFifo* actual_buffer = cfifo;
+    
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_CLEAR))
+    return false;
+
+  while (actual_buffer != NULL)
+  {
+    m_cfifo_This_ClearInternal(actual_buffer);
+    actual_buffer = m_cfifo_GetAdjacentFifo(actual_buffer, direction);
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_This_SetFull(m_cfifo_tCFifo* cfifo)
+{
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_SET_FULL))
+    return false;
+
+  m_cfifo_This_SetFullInternal(cfifo);
+  
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_All_SetFull(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
+{
+    m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_SET_FULL))
+    return false;
+
+  while (actual_buffer != NULL)
+  {
+    m_cfifo_This_SetFullInternal(actual_buffer);
+    actual_buffer = m_cfifo_GetAdjacentFifo(actual_buffer, direction);
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+uint16_t m_cfifo_This_GetSize(m_cfifo_tCFifo* cfifo)
+{
+  uint16_t res = 0;
+  
+  if (!cfifo)
+    return res;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_SIZE))
+    return res;
+
+  res = m_cfifo_This_GetSizeInternal(cfifo);
+  
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+uint32_t m_cfifo_All_GetSize(m_cfifo_tCFifo* cfifo)
+{
+  uint32_t size_total = 0;
+  
+  if (!cfifo)
+    return size_total;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_GET_SIZE))
+    return size_total;
+
+  size_total = 0;
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+ 
+  while (actual_buffer != NULL)
+  {
+    size_total += m_cfifo_This_GetSizeInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+  
+  m_cfifo_Unlock(cfifo);
+  return size_total;
+}
+
+uint16_t m_cfifo_This_GetUsage(m_cfifo_tCFifo* cfifo)
+{
+  uint16_t res = 0;
+
+  if (!cfifo)
+    return res;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_USAGE))
+    return res;
+
+  res = m_cfifo_This_GetUsageInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+uint32_t m_cfifo_All_GetUsage(m_cfifo_tCFifo* cfifo)
+{
+  uint32_t total_used = 0;
+  
+  if (!cfifo)
+    return total_used;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_GET_USAGE))
+    return total_used;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+  total_used = 0;
+  
+  while(actual_buffer != NULL)
+  {
+    total_used += m_cfifo_This_GetUsageInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return total_used;
+}
+
+bool m_cfifo_This_IsEmpty(m_cfifo_tCFifo* cfifo)
+{
+    bool res;
+
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_IS_EMPTY))
+    return false;
+
+  res = m_cfifo_This_IsEmptyInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_All_IsEmpty(m_cfifo_tCFifo* cfifo)
+{
+  bool is_empty = true;
+
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_IS_EMPTY))
+    return false;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+  
+  while (actual_buffer != NULL)
+  {
+    is_empty = is_empty && m_cfifo_This_IsEmptyInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return is_empty;
+}
+
+bool m_cfifo_This_IsFull(m_cfifo_tCFifo* cfifo)
+{
+    bool res;
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_IS_FULL))
+    return false;
+
+  res = m_cfifo_This_IsFullInternal(cfifo);
+    
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_All_IsFull(m_cfifo_tCFifo* cfifo)
+{
+  bool is_full = true;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  if (!cfifo)
+    return false;
+  
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_IS_FULL))
+    return false;
+  
+  while (actual_buffer != NULL)
+  {
+    is_full = is_full && m_cfifo_This_IsFullInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return is_full;
+}
+
+uint8_t m_cfifo_This_GetReadDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint8_t res = 0;
+
+  if (!cfifo || !desc)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_READ_DESCRIPTORS))
+    return res;
+
+  res = m_cfifo_This_GetReadDescriptorsInternal(cfifo, desc, max_desc);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+uint8_t m_cfifo_All_GetReadDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint8_t desc_count = 0;
+
+  if (!cfifo || !desc)
+    return desc_count;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_GET_READ_DESCRIPTORS))
+    return desc_count;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  while (actual_buffer != NULL && desc_count < max_desc)
+  {
+    desc_count += m_cfifo_This_GetReadDescriptorsInternal(actual_buffer, &desc[desc_count], max_desc - desc_count);
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return desc_count;
+}
+
+uint8_t m_cfifo_This_GetWriteDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint8_t res = 0;
+
+  if (!cfifo || !desc)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GET_WRITE_DESCRIPTORS))
+    return res;
+
+  res = m_cfifo_This_GetWriteDescriptorsInternal(cfifo, desc, max_desc);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+uint8_t m_cfifo_All_GetWriteDescriptors(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint8_t desc_count = 0;
+
+  if (!cfifo || !desc)
+    return desc_count;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_GET_WRITE_DESCRIPTORS))
+    return desc_count;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  while (actual_buffer != NULL && desc_count < max_desc)
+  {
+    desc_count += m_cfifo_This_GetWriteDescriptorsInternal(actual_buffer, &desc[desc_count], max_desc - desc_count);
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return desc_count;
+}
+
+bool m_cfifo_This_ReadDone(m_cfifo_tCFifo* cfifo, uint16_t length)
+{
+  bool res = false;
+
+  if (!cfifo)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_READ_DONE))
+    return res;
+
+  if (length <= m_cfifo_This_GetUsageInternal(cfifo))
+  {
+    m_cfifo_This_ReadDoneInternal(cfifo, length);
+    res = true;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_All_ReadDone(m_cfifo_tCFifo* cfifo, uint32_t length)
+{
+  uint32_t total_used = 0;
+
+  if (!cfifo)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_READ_DONE))
+    return false;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  while (actual_buffer != NULL)
+  {
+    total_used += m_cfifo_This_GetUsageInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+
+  if (length > total_used)
+  {
+    m_cfifo_Unlock(cfifo);
+    return false;
+  }
+
+  actual_buffer = cfifo;
+
+  while (length > 0 && actual_buffer != NULL)
+  {
+    uint16_t chunk = m_cfifo_This_GetUsageInternal(actual_buffer);
+
+    if (chunk > length)
+      chunk = (uint16_t)length;
+
+    m_cfifo_This_ReadDoneInternal(actual_buffer, chunk);
+    length -= chunk;
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+bool m_cfifo_This_WriteDone(m_cfifo_tCFifo* cfifo, uint16_t length)
+{
+  bool res = false;
+
+  if (!cfifo)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_WRITE_DONE))
+    return res;
+
+  if (length <= m_cfifo_This_GetFreeInternal(cfifo))
+  {
+    m_cfifo_This_WriteDoneInternal(cfifo, length);
+    res = true;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_All_WriteDone(m_cfifo_tCFifo* cfifo, uint32_t length)
+{
+  uint32_t total_free = 0;
+
+  if (!cfifo)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_ALL_WRITE_DONE))
+    return false;
+
+  m_cfifo_tCFifo* actual_buffer = cfifo;
+
+  while (actual_buffer != NULL)
+  {
+    total_free += m_cfifo_This_GetFreeInternal(actual_buffer);
+    actual_buffer = actual_buffer->next;
+  }
+
+  if (length > total_free)
+  {
+    m_cfifo_Unlock(cfifo);
+    return false;
+  }
+
+  actual_buffer = cfifo;
+
+  while (length > 0 && actual_buffer != NULL)
+  {
+    uint16_t chunk = m_cfifo_This_GetFreeInternal(actual_buffer);
+
+    if (chunk > length)
+      chunk = (uint16_t)length;
+
+    m_cfifo_This_WriteDoneInternal(actual_buffer, chunk);
+    length -= chunk;
+    actual_buffer = actual_buffer->next;
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+uint8_t* m_cfifo_This_Reserve(m_cfifo_tCFifo* cfifo, uint16_t length)
+{
+  m_cfifo_tDescriptor desc;
+  uint8_t* res = NULL;
+
+  if (!cfifo || length == 0)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_RESERVE))
+    return res;
+
+  if (cfifo->buffer != NULL && cfifo->used_count == 0 && cfifo->grant_count == 0)
+  {
+    // nothing stored, start over at the beginning for the largest region
+    cfifo->rdPtr    = 0;
+    cfifo->wrPtr    = 0;
+    cfifo->wrap_gap = 0;
+  }
+
+  if (m_cfifo_This_GetWriteDescriptorsInternal(cfifo, &desc, 1) == 1)
+  {
+    if (desc.length >= length)
+    {
+      res = desc.address;
+    }
+    else if (cfifo->wrPtr >= cfifo->rdPtr && cfifo->rdPtr >= length)
+    {
+      // wrap early, readers skip the unused tail
+      cfifo->wrap_gap = cfifo->buffer_size - cfifo->wrPtr;
+      cfifo->wrPtr    = 0;
+      res = cfifo->buffer;
+    }
+  }
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+uint8_t* m_cfifo_This_Grant(m_cfifo_tCFifo* cfifo, uint16_t length, uint8_t* grant_id)
+{
+  m_cfifo_tGrant* grant;
+  uint8_t* res = NULL;
+  uint16_t frontier;
+  uint32_t granted = 0;
+  uint32_t available;
+  uint16_t offset;
+
+  if (!cfifo || !grant_id || length == 0)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_GRANT))
+    return res;
+
+  // frees the slots of grants committed from ISRs
+  m_cfifo_PublishGrantsInternal(cfifo);
+
+  if (cfifo->buffer == NULL || cfifo->grant_count >= M_CFIFO_MAX_GRANTS)
+  {
+    m_cfifo_Unlock(cfifo);
+    return res;
+  }
+
+  if (cfifo->used_count == 0 && cfifo->grant_count == 0)
+  {
+    // nothing stored, start over at the beginning for the largest region
+    cfifo->rdPtr    = 0;
+    cfifo->wrPtr    = 0;
+    cfifo->wrap_gap = 0;
+  }
+
+  // an ISR may shorten the newest grant while the frontier is computed
+  taskENTER_CRITICAL(&cfifo->grant_lock);
+
+  frontier = cfifo->wrPtr;
+
+  for (uint8_t i = 0; i < cfifo->grant_count; i++)
+  {
+    granted += cfifo->grants[i].length;
+    frontier = (uint16_t)(((uint32_t)cfifo->grants[i].offset + cfifo->grants[i].length) % cfifo->buffer_size);
+  }
+
+  available = (uint32_t)cfifo->buffer_size - cfifo->used_count - cfifo->wrap_gap - granted;
+  offset    = frontier;
+
+  if (available < length)
+  {
+    offset = UINT16_MAX;
+  }
+  else if (frontier >= cfifo->rdPtr && cfifo->buffer_size - frontier < length)
+  {
+    // too short up to the end of the buffer: wrap early, readers skip the unused tail
+    if (cfifo->rdPtr >= length)
+    {
+      cfifo->wrap_gap = cfifo->buffer_size - frontier;
+      offset = 0;
+    }
+    else
+    {
+      offset = UINT16_MAX;
+    }
+  }
+
+  if (offset != UINT16_MAX)
+  {
+    grant = &cfifo->grants[cfifo->grant_count++];
+    grant->offset = offset;
+    grant->length = length;
+    grant->id      = cfifo->grant_seq++;
+    grant->done    = false;
+    grant->aborted = false;
+
+    *grant_id = grant->id;
+    res = &cfifo->buffer[offset];
+  }
+
+  taskEXIT_CRITICAL(&cfifo->grant_lock);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_This_Commit(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length)
+{
+  bool res;
+
+  if (!cfifo)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_COMMIT))
+    return false;
+
+  taskENTER_CRITICAL(&cfifo->grant_lock);
+  res = m_cfifo_CompleteGrantInternal(cfifo, grant_id, length);
+  taskEXIT_CRITICAL(&cfifo->grant_lock);
+
+  // also publishes grants completed from ISRs in the meantime
+  m_cfifo_PublishGrantsInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_This_CommitFromISR(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length)
+{
+  bool res;
+
+  if (!cfifo)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, cfifo, M_CFIFO_API_THIS_COMMIT_FROM_ISR);
+
+  taskENTER_CRITICAL_ISR(&cfifo->grant_lock);
+  res = m_cfifo_CompleteGrantInternal(cfifo, grant_id, length);
+  taskEXIT_CRITICAL_ISR(&cfifo->grant_lock);
+
+  return res;
+}
+
+bool m_cfifo_This_Abort(m_cfifo_tCFifo* cfifo, uint8_t grant_id)
+{
+  m_cfifo_tGrant grant = {0};
+  uint8_t index = 0;
+  bool newest = false;
+  bool res = false;
+
+  if (!cfifo)
+    return res;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_ABORT))
+    return res;
+
+  taskENTER_CRITICAL(&cfifo->grant_lock);
+  for (uint8_t i = 0; i < cfifo->grant_count; i++)
+  {
+    if (cfifo->grants[i].id == grant_id && !cfifo->grants[i].done)
+    {
+      grant  = cfifo->grants[i];
+      index  = i;
+      newest = i == cfifo->grant_count - 1;
+      res    = true;
+      break;
+    }
+  }
+
+  // the newest grant is simply cancelled, older ones are followed by
+  // newer regions: theirs is skipped once the reader got up to it
+  if (res && newest)
+  {
+    res = m_cfifo_CompleteGrantInternal(cfifo, grant_id, 0);
+  }
+  else if (res)
+  {
+    res = m_cfifo_CompleteGrantInternal(cfifo, grant_id, grant.length);
+    cfifo->grants[index].aborted = true;
+  }
+  taskEXIT_CRITICAL(&cfifo->grant_lock);
+
+  m_cfifo_PublishGrantsInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return res;
+}
+
+bool m_cfifo_This_PublishGrants(m_cfifo_tCFifo* cfifo)
+{
+  if (!cfifo)
+    return false;
+
+  if (!m_cfifo_Lock(cfifo, M_CFIFO_API_THIS_PUBLISH_GRANTS))
+    return false;
+
+  m_cfifo_PublishGrantsInternal(cfifo);
+
+  m_cfifo_Unlock(cfifo);
+  return true;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static bool m_cfifo_This_PushInternal(m_cfifo_tCFifo* cfifo, uint8_t data)
+{
+    if (cfifo->buffer == NULL)
+        return false;
+
+    if (m_cfifo_This_GetFreeInternal(cfifo) == 0)
+        return false;
+
+    cfifo->buffer[cfifo->wrPtr] = data;
+    m_cfifo_IncWrPtr(cfifo);
+    cfifo->used_count++;
+    m_cfifo_OnWrittenInternal(cfifo, 1);
+
+    return true;
+}
+
+static uint16_t m_cfifo_This_PushBlockInternal(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length)
+{
+  m_cfifo_tDescriptor desc[2];
+  uint8_t desc_count;
+  uint16_t written = 0;
+
+  desc_count = m_cfifo_This_GetWriteDescriptorsInternal(cfifo, desc, 2);
+
+  for (uint8_t i = 0; i < desc_count && written < length; i++)
+  {
+    uint16_t chunk = desc[i].length;
+
+    if (chunk > length - written)
+      chunk = length - written;
+
+    memcpy(desc[i].address, &data[written], chunk);
+    written += chunk;
+  }
+
+  m_cfifo_This_WriteDoneInternal(cfifo, written);
+  return written;
+}
+
+static bool m_cfifo_This_PopInternal(m_cfifo_tCFifo* cfifo, uint8_t* data)
+{
+    if (m_cfifo_This_IsEmptyInternal(cfifo))
+        return false;
+
+    if (cfifo->buffer == NULL)
+    {
+        if (data != NULL)
+            *data = cfifo->dummy_byte;
+    }
+    else
+    {
+        if (data != NULL)
+            *data = cfifo->buffer[cfifo->rdPtr];
+    }
+
+    m_cfifo_IncRdPtr(cfifo);
+    cfifo->used_count--;
+    m_cfifo_OnReadInternal(cfifo, 1);
+
+    return true;
+}
+
+static uint16_t m_cfifo_This_PopBlockInternal(m_cfifo_tCFifo* cfifo, uint8_t* data, uint16_t length, m_cfifo_tTransform transform, uint8_t mask)
+{
+  m_cfifo_tDescriptor desc[2] = {{NULL, 0}, {NULL, 0}};
+  uint8_t width = m_cfifo_TransformWidth(transform);
+  uint8_t word[4];
+  uint16_t first;
+  uint16_t straddle;
+
+  if (length > cfifo->used_count)
+    length = cfifo->used_count;
+
+  length -= length % width;
+
+  if (length == 0)
+    return 0;
+
+  if (cfifo->buffer == NULL)
+  {
+    // unconfigured FIFO, like m_cfifo_This_PopInternal
+    memset(data, cfifo->dummy_byte, length);
+    m_cfifo_This_ReadDoneInternal(cfifo, length);
+    return length;
+  }
+
+  m_cfifo_This_GetReadDescriptorsInternal(cfifo, desc, 2);
+
+  first = desc[0].length < length ? desc[0].length : length;
+  straddle = first % width;
+  first -= straddle;
+
+  m_cfifo_TransformCopy(data, desc[0].address, first, transform, mask);
+
+  if (straddle != 0)
+  {
+    // a word crosses the wrap point: gather it before transforming
+    memcpy(word, &desc[0].address[first], straddle);
+    memcpy(&word[straddle], desc[1].address, width - straddle);
+    m_cfifo_TransformCopy(&data[first], word, width, transform, mask);
+    first += width;
+  }
+
+  if (length > first)
+    m_cfifo_TransformCopy(&data[first], &desc[1].address[(width - straddle) % width], length - first, transform, mask);
+
+  m_cfifo_This_ReadDoneInternal(cfifo, length);
+  return length;
+}
+
+static uint16_t m_cfifo_This_PeekInternal(m_cfifo_tCFifo* cfifo, uint16_t skip, uint8_t* data, uint16_t length)
+{
+  m_cfifo_tDescriptor desc[2];
+  uint8_t desc_count;
+  uint16_t copied = 0;
+
+  if (skip >= cfifo->used_count)
+    return 0;
+
+  if (length > cfifo->used_count - skip)
+    length = cfifo->used_count - skip;
+
+  if (cfifo->buffer == NULL)
+  {
+    memset(data, cfifo->dummy_byte, length);
+    return length;
+  }
+
+  desc_count = m_cfifo_This_GetReadDescriptorsInternal(cfifo, desc, 2);
+
+  for (uint8_t i = 0; i < desc_count && copied < length; i++)
+  {
+    uint16_t chunk;
+
+    if (skip >= desc[i].length)
+    {
+      skip -= desc[i].length;
+      continue;
+    }
+
+    chunk = desc[i].length - skip;
+
+    if (chunk > length - copied)
+      chunk = length - copied;
+
+    memcpy(&data[copied], &desc[i].address[skip], chunk);
+    copied += chunk;
+    skip = 0;
+  }
+
+  return copied;
+}
+
+static void m_cfifo_This_ClearInternal(m_cfifo_tCFifo* cfifo)
+{
+    cfifo->grant_count = 0;
+    cfifo->wrap_gap = 0;
+    cfifo->rd_total = cfifo->wr_total;
+    cfifo->rdPtr = 0;
+    cfifo->wrPtr = 0;
+    cfifo->used_count = 0;
+    m_cfifo_OnResetInternal(cfifo);
+}
+
+static void m_cfifo_This_SetFullInternal(m_cfifo_tCFifo* cfifo)
+{
+    cfifo->grant_count = 0;
+    cfifo->wrap_gap = 0;
+    cfifo->wr_total = cfifo->rd_total + cfifo->buffer_size;
+    cfifo->rdPtr = 0;
+    cfifo->wrPtr = 0;
+    cfifo->used_count = cfifo->buffer_size;
+    m_cfifo_OnResetInternal(cfifo);
+}
+
+static uint16_t m_cfifo_This_GetSizeInternal(m_cfifo_tCFifo* cfifo)
+{
+    return cfifo->buffer_size;
+}
+
+static uint16_t m_cfifo_This_GetUsageInternal(m_cfifo_tCFifo* cfifo)
+{
+    return cfifo->used_count;
+}
+
+static bool m_cfifo_This_IsEmptyInternal(m_cfifo_tCFifo* cfifo)
+{
+    bool is_empty;
+
+    is_empty = cfifo->used_count == 0;
+
+    return is_empty;
+}
+
+static bool m_cfifo_This_IsFullInternal(m_cfifo_tCFifo* cfifo)
+{
+    bool is_full;
+
+    is_full = cfifo->used_count + cfifo->wrap_gap >= cfifo->buffer_size;
+
+    return is_full;
+}
+
+static void m_cfifo_IncRdPtr(m_cfifo_tCFifo* cfifo)
+{
+  cfifo->rdPtr++;
+
+  if (cfifo->rdPtr >= cfifo->buffer_size - cfifo->wrap_gap)
+  {
+    cfifo->rdPtr = 0;
+    cfifo->wrap_gap = 0;
+  }
+}
+
+static void m_cfifo_IncWrPtr(m_cfifo_tCFifo* cfifo)
+{
+  cfifo->wrPtr = (cfifo->wrPtr + 1) % cfifo->buffer_size;
+}
+
+static m_cfifo_tCFifo* m_cfifo_GetAdjacentFifo(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
+{
+  if (cfifo == NULL)
+    return NULL;
+    
+  if (direction == M_CFIFO_UP)
+    return cfifo->next;
+  else if (direction == M_CFIFO_DOWN)
+    return cfifo->prev;
+  else
+    return NULL;
+}
+
+static uint16_t m_cfifo_This_GetFreeInternal(m_cfifo_tCFifo* cfifo)
+{
+  // outstanding grants own the space behind wrPtr
+  if (cfifo->buffer == NULL || cfifo->grant_count > 0 || m_cfifo_This_IsFullInternal(cfifo))
+    return 0;
+
+  return cfifo->buffer_size - cfifo->wrap_gap - cfifo->used_count;
+}
+
+static uint8_t m_cfifo_This_GetReadDescriptorsInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint16_t remaining = cfifo->used_count;
+  uint16_t position  = cfifo->rdPtr;
+  uint8_t desc_count = 0;
+
+  if (cfifo->buffer == NULL)
+    return 0;
+
+  while (remaining > 0 && desc_count < max_desc)
+  {
+    uint16_t chunk = cfifo->buffer_size - cfifo->wrap_gap - position;
+
+    if (chunk > remaining)
+      chunk = remaining;
+
+    desc[desc_count].address = &cfifo->buffer[position];
+    desc[desc_count].length  = chunk;
+    desc_count++;
+
+    remaining -= chunk;
+    position = 0;
+  }
+
+  return desc_count;
 }
 
+static uint8_t m_cfifo_This_GetWriteDescriptorsInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tDescriptor* desc, uint8_t max_desc)
+{
+  uint16_t remaining = m_cfifo_This_GetFreeInternal(cfifo);
+  uint16_t position  = cfifo->wrPtr;
+  uint8_t desc_count = 0;
 
+  while (remaining > 0 && desc_count < max_desc)
+  {
+    uint16_t chunk = cfifo->buffer_size - position;
 
-//*****************************************************************************
-// Local Functions
-//*****************************************************************************
+    if (chunk > remaining)
+      chunk = remaining;
 
-static bool m_cfifo_This_PushInternal(m_cfifo_tCFifo* cfifo, uint8_t data)
+    desc[desc_count].address = &cfifo->buffer[position];
+    desc[desc_count].length  = chunk;
+    desc_count++;
+
+    remaining -= chunk;
+    position = 0;
+  }
+
+  return desc_count;
+}
+
+static void m_cfifo_This_ReadDoneInternal(m_cfifo_tCFifo* cfifo, uint16_t length)
 {
-    if (cfifo->buffer == NULL)
-        return false;
+  uint32_t position = (uint32_t)cfifo->rdPtr + length;
+  uint16_t end = cfifo->buffer_size - cfifo->wrap_gap;
 
-    if (m_cfifo_This_IsFullInternal(cfifo))
-        return false;
+  if (length == 0)
+    return;
 
-    cfifo->buffer[cfifo->wrPtr] = data;
-    m_cfifo_IncWrPtr(cfifo);
-    cfifo->used_count++;
+  if (position >= end)
+  {
+    position -= end;
+    cfifo->wrap_gap = 0;
+  }
 
-    return true;
+  cfifo->rdPtr = (uint16_t)position;
+  cfifo->used_count -= length;
+  m_cfifo_OnReadInternal(cfifo, length);
 }
 
-static bool m_cfifo_This_PopInternal(m_cfifo_tCFifo* cfifo, uint8_t* data)
+static void m_cfifo_This_WriteDoneInternal(m_cfifo_tCFifo* cfifo, uint16_t length)
 {
-    if (m_cfifo_This_IsEmptyInternal(cfifo))
-        return false;
+  if (length == 0)
+    return;
 
-    if (cfifo->buffer == NULL)
+  cfifo->wrPtr = (uint16_t)(((uint32_t)cfifo->wrPtr + length) % cfifo->buffer_size);
+  cfifo->used_count += length;
+  m_cfifo_OnWrittenInternal(cfifo, length);
+}
+
+static inline bool m_cfifo_Lock(m_cfifo_tCFifo* cfifo, m_cfifo_tTraceApi api)
+{
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, cfifo, api);
+
+  if (xSemaphoreTake(cfifo->semaphore, 0) == pdTRUE)
+  {
+    cfifo->lock_stats.acquisitions++;
+    return true;
+  }
+
+  if (!m_cfifo_SpinInternal(cfifo))
+  {
+    M_CFIFO_TRACE(M_CFIFO_TRACE_BLOCK, cfifo, api);
+
+    if (xSemaphoreTake(cfifo->semaphore, M_CFIFO_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
     {
-        if (data != NULL)
-            *data = cfifo->dummy_byte;
+      // close the blocked slice of the trace also on a timeout
+      M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, cfifo, api);
+      return false;
     }
-    else
+
+    M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, cfifo, api);
+    cfifo->lock_stats.blocked++;
+
+#if portNUM_PROCESSORS > 1
+    if (cfifo->lock_policy == M_CFIFO_LOCK_ADAPTIVE)
+      m_cfifo_SpinSampleInternal(cfifo, 0);
+#endif
+  }
+
+  cfifo->lock_stats.acquisitions++;
+  cfifo->lock_stats.contended++;
+  return true;
+}
+
+static inline void m_cfifo_Unlock(m_cfifo_tCFifo* cfifo)
+{
+  xSemaphoreGive(cfifo->semaphore);
+}
+
+static void m_cfifo_OnWrittenInternal(m_cfifo_tCFifo* cfifo, uint16_t length)
+{
+  m_cfifo_tLatency* latency = cfifo->latency;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_PUSH, cfifo, length);
+
+  cfifo->wr_total += length;
+
+  // every write path ends here: DMA, grants and reservations included
+  if (length > 0)
+    m_cfifo_WakeWaiterInternal(cfifo);
+
+  if (cfifo->used_count > cfifo->peak_count)
+    cfifo->peak_count = cfifo->used_count;
+
+  if (latency == NULL || length == 0)
+    return;
+
+  if (latency->countdown > length)
+  {
+    latency->countdown -= length;
+    return;
+  }
+
+  // the sampled byte is the countdown-th byte of this write
+  if (latency->in_flight)
+  {
+    latency->skipped++;
+  }
+  else
+  {
+    latency->ahead     = cfifo->used_count - length + (uint16_t)(latency->countdown - 1);
+    latency->stamp     = esp_timer_get_time();
+    latency->in_flight = true;
+  }
+
+  latency->countdown = latency->every;
+}
+
+static void m_cfifo_OnReadInternal(m_cfifo_tCFifo* cfifo, uint16_t length)
+{
+  m_cfifo_tLatency* latency = cfifo->latency;
+  int64_t elapsed;
+  uint32_t us;
+  uint8_t bucket = 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_POP, cfifo, length);
+
+  cfifo->rd_total += length;
+  cfifo->sent_count = cfifo->sent_count > length ? cfifo->sent_count - length : 0;
+
+  if (length > 0)
+    m_cfifo_OnReleasedInternal(cfifo, length);
+
+  if (latency != NULL && latency->in_flight && latency->ahead >= length)
+  {
+    latency->ahead -= length;
+  }
+  else if (latency != NULL && latency->in_flight)
+  {
+    elapsed = esp_timer_get_time() - latency->stamp;
+    us = elapsed > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+
+    if (us > 0)
+      bucket = (uint8_t)(32 - __builtin_clz(us));
+
+    if (bucket >= M_CFIFO_LATENCY_BUCKETS)
+      bucket = M_CFIFO_LATENCY_BUCKETS - 1;
+
+    latency->buckets[bucket]++;
+    latency->samples++;
+
+    if (us > latency->max_us)
+      latency->max_us = us;
+
+    latency->in_flight = false;
+  }
+
+  // the reader got up to an aborted grant region, skip it and publish
+  // the grants behind it
+  if (cfifo->used_count == 0 && cfifo->grant_count > 0 && cfifo->grants[0].aborted)
+    m_cfifo_PublishGrantsInternal(cfifo);
+}
+
+static void m_cfifo_OnResetInternal(m_cfifo_tCFifo* cfifo)
+{
+  cfifo->sent_count = 0;
+  m_cfifo_OnReleasedInternal(cfifo, 0);
+
+  if (cfifo->latency != NULL)
+    cfifo->latency->in_flight = false;
+}
+
+static void m_cfifo_OnReleasedInternal(m_cfifo_tCFifo* cfifo, uint16_t released)
+{
+  m_cfifo_tState state;
+
+  if (cfifo->release_hook == NULL)
+    return;
+
+  m_cfifo_This_GetStateInternal(cfifo, &state);
+  cfifo->release_hook(&state, released, cfifo->release_arg);
+}
+
+static void m_cfifo_This_GetStateInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tState* state)
+{
+  state->buffer_size = cfifo->buffer_size;
+  state->used_count  = cfifo->used_count;
+  state->rdPtr       = cfifo->rdPtr;
+  state->wrPtr       = cfifo->wrPtr;
+  state->wrap_gap    = cfifo->wrap_gap;
+}
+
+static bool m_cfifo_SpinInternal(m_cfifo_tCFifo* cfifo)
+{
+#if portNUM_PROCESSORS > 1
+  m_cfifo_tLockStats* stats = &cfifo->lock_stats;
+  uint16_t budget;
+
+  if (cfifo->lock_policy != M_CFIFO_LOCK_ADAPTIVE)
+    return false;
+
+  // written by the lock holder only, a stale value just shifts the budget
+  budget = __atomic_load_n(&stats->spin_budget, __ATOMIC_RELAXED);
+
+  for (uint16_t spins = 1; spins <= budget; spins++)
+  {
+    // read-only poll, the take (an RMW on the semaphore) only when it looks free
+    if (uxSemaphoreGetCount(cfifo->semaphore) == 1 && xSemaphoreTake(cfifo->semaphore, 0) == pdTRUE)
     {
-        if (data != NULL)
-            *data = cfifo->buffer[cfifo->rdPtr];
+      m_cfifo_SpinSampleInternal(cfifo, spins);
+      stats->spin_acquired++;
+      return true;
     }
+  }
+#endif
 
-    m_cfifo_IncRdPtr(cfifo);
-    cfifo->used_count--;
-
-    return true;
+  return false;
 }
 
-static void m_cfifo_This_ClearInternal(m_cfifo_tCFifo* cfifo)
+#if portNUM_PROCESSORS > 1
+static void m_cfifo_SpinSampleInternal(m_cfifo_tCFifo* cfifo, uint16_t spins)
 {
-    cfifo->rdPtr = 0;
-    cfifo->wrPtr = 0;
-    cfifo->used_count = 0;
+  m_cfifo_tLockStats* stats = &cfifo->lock_stats;
+  int32_t avg;
+
+  // EWMA (1/8) of the attempts needed, kept in 1/16 units; exhausted
+  // spins count as 0, so long hold times shrink the budget to the minimum
+  avg  = stats->spin_avg;
+  avg += ((int32_t)spins * 16 - avg) / 8;
+
+  stats->spin_avg    = (uint16_t)avg;
+  stats->spin_budget = (uint16_t)(avg / 8 + M_CFIFO_SPIN_MIN > M_CFIFO_SPIN_MAX ? M_CFIFO_SPIN_MAX : avg / 8 + M_CFIFO_SPIN_MIN);
 }
+#endif
 
-static void m_cfifo_This_SetFullInternal(m_cfifo_tCFifo* cfifo)
+static bool m_cfifo_InitBufferInternal(m_cfifo_tCFifo* cfifo, m_cfifo_tLockType lock_type, StaticSemaphore_t* semaphore_buffer)
 {
-    cfifo->rdPtr = 0;
-    cfifo->wrPtr = 0;
-    cfifo->used_count = cfifo->buffer_size;
+  switch (lock_type)
+  {
+    case M_CFIFO_LOCK_TYPE_BINARY:
+      cfifo->semaphore = semaphore_buffer ? xSemaphoreCreateBinaryStatic(semaphore_buffer) : xSemaphoreCreateBinary();
+
+      // binary semaphores are created in the taken state
+      if (cfifo->semaphore != NULL)
+        xSemaphoreGive(cfifo->semaphore);
+      break;
+
+    case M_CFIFO_LOCK_TYPE_MUTEX:
+      cfifo->semaphore = semaphore_buffer ? xSemaphoreCreateMutexStatic(semaphore_buffer) : xSemaphoreCreateMutex();
+      break;
+
+    default:
+      return false;
+  }
+
+  if (cfifo->semaphore == NULL)
+    return false;
+
+  m_cfifo_InitFieldsInternal(cfifo);
+  cfifo->lock_type = lock_type;
+  m_cfifo_ConfigBuffer(cfifo, NULL, 0);
+
+  return true;
 }
 
-static uint16_t m_cfifo_This_GetSizeInternal(m_cfifo_tCFifo* cfifo)
+static void m_cfifo_InitFieldsInternal(m_cfifo_tCFifo* cfifo)
 {
-    return cfifo->buffer_size;
+  cfifo->prev = NULL;
+  cfifo->next = NULL;
+  cfifo->dummy_byte = 0x00;
+  cfifo->sent_count = 0;
+  cfifo->wrap_gap = 0;
+  cfifo->grant_count = 0;
+  cfifo->grant_seq = 0;
+  portMUX_INITIALIZE(&cfifo->grant_lock);
+  cfifo->rd_total = 0;
+  cfifo->wr_total = 0;
+  cfifo->rate_limit = NULL;
+  cfifo->waiter = NULL;
+  cfifo->latency = NULL;
+  cfifo->release_hook = NULL;
+  cfifo->release_arg = NULL;
+  cfifo->lock_policy = M_CFIFO_LOCK_BLOCK;
+  memset(&cfifo->lock_stats, 0, sizeof(cfifo->lock_stats));
+  cfifo->lock_stats.spin_budget = M_CFIFO_SPIN_MIN;
+  cfifo->peak_count = 0;
+  // name and registry_next belong to the registry and survive re-initialization
 }
 
-static uint16_t m_cfifo_This_GetUsageInternal(m_cfifo_tCFifo* cfifo)
+static uint32_t m_cfifo_RateLimitAvailable(m_cfifo_tCFifo* cfifo)
 {
-    return cfifo->used_count;
+  m_cfifo_tRateLimit* limit = cfifo->rate_limit;
+  TickType_t elapsed;
+  uint64_t tokens;
+  uint32_t periods;
+
+  if (limit == NULL)
+    return UINT32_MAX;
+
+  elapsed = xTaskGetTickCount() - limit->last_refill;
+
+  if (elapsed >= limit->interval)
+  {
+    periods = elapsed / limit->interval;
+    tokens  = limit->tokens + (uint64_t)periods * limit->bytes_per_interval;
+
+    limit->tokens       = tokens > limit->burst ? limit->burst : (uint32_t)tokens;
+    limit->last_refill += periods * limit->interval;
+  }
+
+  return limit->tokens;
 }
 
-static bool m_cfifo_This_IsEmptyInternal(m_cfifo_tCFifo* cfifo)
+static void m_cfifo_RateLimitConsume(m_cfifo_tCFifo* cfifo, uint32_t length)
 {
-    bool is_empty;
+  if (cfifo->rate_limit != NULL)
+    cfifo->rate_limit->tokens -= length;
+}
 
-    is_empty = cfifo->used_count == 0;
+static TickType_t m_cfifo_RateLimitDelay(m_cfifo_tCFifo* cfifo)
+{
+  if (m_cfifo_RateLimitAvailable(cfifo) > 0)
+    return 0;
 
-    return is_empty;
+  return cfifo->rate_limit->interval - (xTaskGetTickCount() - cfifo->rate_limit->last_refill);
 }
 
-static bool m_cfifo_This_IsFullInternal(m_cfifo_tCFifo* cfifo)
+static uint16_t m_cfifo_HandoffInternal(m_cfifo_tCFifo* cfifo, const uint8_t* data, uint16_t length)
 {
-    bool is_full;
+  m_cfifo_tWaiter* waiter = cfifo->waiter;
+  uint32_t handed = 0;
 
-    is_full = cfifo->used_count >= cfifo->buffer_size;
+  if (waiter == NULL)
+    return 0;
 
-    return is_full;
+  // unregister first, the accounting below must not wake it a second time
+  cfifo->waiter = NULL;
+
+  if (cfifo->used_count == 0 && cfifo->grant_count == 0)
+  {
+    handed = m_cfifo_RateLimitAvailable(cfifo);
+
+    if (handed > length)
+      handed = length;
+
+    if (handed > waiter->length)
+      handed = waiter->length;
+
+    memcpy(waiter->data, data, handed);
+    waiter->received = (uint16_t)handed;
+    m_cfifo_RateLimitConsume(cfifo, handed);
+
+    // account the bytes as if they passed through the empty ring
+    cfifo->used_count = (uint16_t)handed;
+    m_cfifo_OnWrittenInternal(cfifo, (uint16_t)handed);
+    cfifo->used_count = 0;
+    m_cfifo_OnReadInternal(cfifo, (uint16_t)handed);
+  }
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT);
+  xTaskNotifyGiveIndexed(waiter->task, M_CFIFO_NOTIFY_INDEX);
+
+  return (uint16_t)handed;
 }
 
-static void m_cfifo_IncRdPtr(m_cfifo_tCFifo* cfifo)
+static void m_cfifo_WakeWaiterInternal(m_cfifo_tCFifo* cfifo)
 {
-  cfifo->rdPtr = (cfifo->rdPtr + 1) % cfifo->buffer_size;
+  m_cfifo_tWaiter* waiter = cfifo->waiter;
+
+  if (waiter == NULL)
+    return;
+
+  cfifo->waiter = NULL;
+  M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, cfifo, M_CFIFO_API_THIS_POP_BLOCK_WAIT);
+  xTaskNotifyGiveIndexed(waiter->task, M_CFIFO_NOTIFY_INDEX);
 }
 
-static void m_cfifo_IncWrPtr(m_cfifo_tCFifo* cfifo)
+static uint16_t m_cfifo_FindByte(const uint8_t* data, uint16_t length, uint8_t value)
 {
-  cfifo->wrPtr = (cfifo->wrPtr + 1) % cfifo->buffer_size;
+  uint16_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8((char)value);
+
+  for (; i + 16 <= length; i += 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)&data[i]);
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+
+    if (mask != 0)
+      return i + (uint16_t)__builtin_ctz((unsigned)mask);
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t needle = vdupq_n_u8(value);
+
+  for (; i + 16 <= length; i += 16)
+  {
+    uint8x16_t eq = vceqq_u8(vld1q_u8(&data[i]), needle);
+    // narrow to one nibble per byte to get a 64 bit match mask
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+
+    if (mask != 0)
+      return i + (uint16_t)(__builtin_ctzll(mask) >> 2);
+  }
+#else
+  const uint32_t ones  = 0x01010101u;
+  const uint32_t highs = 0x80808080u;
+  const uint32_t needle = value * ones;
+
+  // head bytes until word aligned, no unaligned loads on Xtensa
+  for (; i < length && ((uintptr_t)&data[i] & 3u) != 0; i++)
+  {
+    if (data[i] == value)
+      return i;
+  }
+
+  for (; i + 4 <= length; i += 4)
+  {
+    uint32_t word;
+
+    memcpy(&word, &data[i], sizeof(word));
+    word ^= needle;
+
+    // nonzero if any byte of word is zero, i.e. equal to value
+    if (((word - ones) & ~word & highs) != 0)
+      break;
+  }
+#endif
+
+  for (; i < length; i++)
+  {
+    if (data[i] == value)
+      return i;
+  }
+
+  return length;
 }
 
-static m_cfifo_tCFifo* m_cfifo_GetAdjacentFifo(m_cfifo_tCFifo* cfifo, m_cfifo_tDirection direction)
+static bool m_cfifo_MatchAt(const m_cfifo_tDescriptor* desc, uint16_t offset, const uint8_t* pattern, uint16_t length)
 {
-  if (cfifo == NULL)
-    return NULL;
-    
-  if (direction == M_CFIFO_UP)
-    return cfifo->next;
-  else if (direction == M_CFIFO_DOWN)
-    return cfifo->prev;
+  uint16_t first = 0;
+
+  if (offset < desc[0].length)
+  {
+    first = desc[0].length - offset;
+
+    if (first > length)
+      first = length;
+
+    if (memcmp(&desc[0].address[offset], pattern, first) != 0)
+      return false;
+
+    offset = 0;
+  }
   else
-    return NULL;
+  {
+    offset -= desc[0].length;
+  }
+
+  return first == length || memcmp(&desc[1].address[offset], &pattern[first], length - first) == 0;
+}
+
+static uint8_t m_cfifo_TransformWidth(m_cfifo_tTransform transform)
+{
+  switch (transform)
+  {
+    case M_CFIFO_TRANSFORM_BSWAP16:
+      return 2;
+
+    case M_CFIFO_TRANSFORM_BSWAP32:
+      return 4;
+
+    default:
+      return 1;
+  }
+}
+
+static void m_cfifo_TransformCopy(uint8_t* dst, const uint8_t* src, uint16_t length, m_cfifo_tTransform transform, uint8_t mask)
+{
+  static const uint8_t bitrev[256] =
+  {
+#define M_CFIFO_R2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define M_CFIFO_R4(n) M_CFIFO_R2(n), M_CFIFO_R2(n + 2 * 16), M_CFIFO_R2(n + 1 * 16), M_CFIFO_R2(n + 3 * 16)
+#define M_CFIFO_R6(n) M_CFIFO_R4(n), M_CFIFO_R4(n + 2 * 4), M_CFIFO_R4(n + 1 * 4), M_CFIFO_R4(n + 3 * 4)
+    M_CFIFO_R6(0), M_CFIFO_R6(2), M_CFIFO_R6(1), M_CFIFO_R6(3)
+#undef M_CFIFO_R6
+#undef M_CFIFO_R4
+#undef M_CFIFO_R2
+  };
+  uint16_t i = 0;
+
+  // simple counted loops over 32 bit words so the compiler can vectorize them
+  switch (transform)
+  {
+    case M_CFIFO_TRANSFORM_XOR:
+    {
+      const uint32_t mask32 = mask * 0x01010101u;
+
+      for (; i + 4 <= length; i += 4)
+      {
+        uint32_t w;
+
+        memcpy(&w, &src[i], sizeof(w));
+        w ^= mask32;
+        memcpy(&dst[i], &w, sizeof(w));
+      }
+
+      for (; i < length; i++)
+        dst[i] = src[i] ^ mask;
+      break;
+    }
+
+    case M_CFIFO_TRANSFORM_BITREV:
+      for (; i < length; i++)
+        dst[i] = bitrev[src[i]];
+      break;
+
+    case M_CFIFO_TRANSFORM_BSWAP16:
+      for (; i < length; i += 2)
+      {
+        uint16_t w;
+
+        memcpy(&w, &src[i], sizeof(w));
+        w = __builtin_bswap16(w);
+        memcpy(&dst[i], &w, sizeof(w));
+      }
+      break;
+
+    case M_CFIFO_TRANSFORM_BSWAP32:
+      for (; i < length; i += 4)
+      {
+        uint32_t w;
+
+        memcpy(&w, &src[i], sizeof(w));
+        w = __builtin_bswap32(w);
+        memcpy(&dst[i], &w, sizeof(w));
+      }
+      break;
+
+    default:
+      memcpy(dst, src, length);
+      break;
+  }
+}
+
+static bool m_cfifo_CompleteGrantInternal(m_cfifo_tCFifo* cfifo, uint8_t grant_id, uint16_t length)
+{
+  for (uint8_t index = 0; index < cfifo->grant_count; index++)
+  {
+    m_cfifo_tGrant* grant = &cfifo->grants[index];
+
+    if (grant->id != grant_id || grant->done)
+      continue;
+
+    if (length > grant->length || (length < grant->length && index != cfifo->grant_count - 1))
+      return false;
+
+    grant->length = length;
+    grant->done   = true;
+    return true;
+  }
+
+  return false;
+}
+
+static void m_cfifo_PublishGrantsInternal(m_cfifo_tCFifo* cfifo)
+{
+  m_cfifo_tGrant grant;
+
+  // publish completed grants in the order they were handed out; the
+  // list is only touched in the critical section, the data outside
+  for (;;)
+  {
+    taskENTER_CRITICAL(&cfifo->grant_lock);
+
+    // an aborted region waits until the bytes in front of it are read
+    if (cfifo->grant_count == 0 || !cfifo->grants[0].done ||
+        (cfifo->grants[0].aborted && cfifo->used_count > 0))
+    {
+      taskEXIT_CRITICAL(&cfifo->grant_lock);
+      break;
+    }
+
+    grant = cfifo->grants[0];
+    cfifo->grant_count--;
+    memmove(&cfifo->grants[0], &cfifo->grants[1], cfifo->grant_count * sizeof(m_cfifo_tGrant));
+
+    taskEXIT_CRITICAL(&cfifo->grant_lock);
+
+    if (grant.aborted)
+    {
+      // nothing stored: move both pointers behind the region, like a wrap gap
+      cfifo->rdPtr = (uint16_t)(((uint32_t)grant.offset + grant.length) % cfifo->buffer_size);
+
+      if (cfifo->rdPtr >= cfifo->buffer_size - cfifo->wrap_gap)
+      {
+        cfifo->rdPtr = 0;
+        cfifo->wrap_gap = 0;
+      }
+
+      cfifo->wrPtr = cfifo->rdPtr;
+      continue;
+    }
+
+    cfifo->wrPtr = grant.offset;
+    m_cfifo_This_WriteDoneInternal(cfifo, grant.length);
+  }
 }
@@ -0,0 +1,261 @@
+/**
+ * @file m_cfifo_audio.c
+ * @brief Implementation of the frame-aligned m_cfifo audio FIFO.
+ *
+ * Design notes:
+ * - The ring size is a multiple of the frame size and all transfers are
+ *   whole frames, so each read/write descriptor holds whole frames and
+ *   no frame is ever split at the wrap point.
+ * - Reads convert straight out of the ring through the read descriptors
+ *   and release the frames afterwards with @ref m_cfifo_This_ReadDone.
+ * - Samples are widened to 32 bit internally; the inner loops are plain
+ *   counted loops the compiler can unroll and vectorize. Interleaved
+ *   output in the stored format is a memcpy.
+ *
+ * @see m_cfifo_audio.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_audio.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+#include <string.h>
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Size of one sample in bytes.
+ *
+ * @param format Sample format.
+ * @return 2 or 4.
+ */
+static inline uint8_t m_cfifo_Audio_SampleSize(m_cfifo_tAudioFormat format);
+
+
+/**
+ * @brief Loads a sample and widens it to 32 bit.
+ *
+ * @param src    Sample address (any alignment).
+ * @param format Stored format.
+ * @return Sample scaled to the full 32 bit range.
+ */
+static inline int32_t m_cfifo_Audio_Load(const uint8_t* src, m_cfifo_tAudioFormat format);
+
+
+/**
+ * @brief Stores a 32 bit sample in the requested format.
+ *
+ * @param dst    Destination address (any alignment).
+ * @param sample Sample scaled to the full 32 bit range.
+ * @param format Output format.
+ */
+static inline void m_cfifo_Audio_Store(uint8_t* dst, int32_t sample, m_cfifo_tAudioFormat format);
+
+
+/**
+ * @brief Converts a run of frames from the ring into the output buffer.
+ *
+ * @param audio      Pointer to the audio handle.
+ * @param src        First frame in the ring.
+ * @param frames     Number of frames in this run.
+ * @param out        Output buffer.
+ * @param first      Index of the first output frame.
+ * @param max_frames Plane length for planar output.
+ * @param format     Output format.
+ * @param layout     Output layout.
+ */
+static void m_cfifo_Audio_Convert(const m_cfifo_tAudio* audio, const uint8_t* src, uint16_t frames, uint8_t* out, uint16_t first, uint16_t max_frames, m_cfifo_tAudioFormat format, m_cfifo_tAudioLayout layout);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Audio_Init(m_cfifo_tAudio* audio, m_cfifo_tCFifo* cfifo, m_cfifo_tAudioFormat format, uint8_t channels)
+{
+  uint16_t size;
+
+  if (!audio || !cfifo || channels == 0 || channels > M_CFIFO_AUDIO_MAX_CHANNELS || format > M_CFIFO_AUDIO_S32)
+    return false;
+
+  audio->cfifo      = cfifo;
+  audio->format     = format;
+  audio->channels   = channels;
+  audio->frame_size = channels * m_cfifo_Audio_SampleSize(format);
+
+  size = m_cfifo_This_GetSize(cfifo);
+
+  if (size == 0 || size % audio->frame_size != 0)
+    return false;
+
+  return m_cfifo_This_Clear(cfifo);
+}
+
+uint16_t m_cfifo_Audio_Write(m_cfifo_tAudio* audio, const void* frames, uint16_t frame_count)
+{
+  m_cfifo_tDescriptor desc[2];
+  const uint8_t* src = (const uint8_t*)frames;
+  uint32_t remaining;
+  uint32_t written = 0;
+  uint8_t desc_count;
+
+  if (!audio || !frames)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, audio, M_CFIFO_API_AUDIO_WRITE);
+
+  remaining  = (uint32_t)frame_count * audio->frame_size;
+  desc_count = m_cfifo_This_GetWriteDescriptors(audio->cfifo, desc, 2);
+
+  for (uint8_t i = 0; i < desc_count && remaining > 0; i++)
+  {
+    uint32_t chunk = desc[i].length;
+
+    if (chunk > remaining)
+      chunk = remaining;
+
+    memcpy(desc[i].address, &src[written], chunk);
+    written   += chunk;
+    remaining -= chunk;
+  }
+
+  if (written > 0 && !m_cfifo_This_WriteDone(audio->cfifo, (uint16_t)written))
+    return 0;
+
+  return (uint16_t)(written / audio->frame_size);
+}
+
+uint16_t m_cfifo_Audio_Read(m_cfifo_tAudio* audio, void* out, uint16_t max_frames, m_cfifo_tAudioFormat format, m_cfifo_tAudioLayout layout)
+{
+  m_cfifo_tDescriptor desc[2];
+  uint16_t frames = 0;
+  uint8_t desc_count;
+
+  if (!audio || !out || format > M_CFIFO_AUDIO_S32 || layout > M_CFIFO_AUDIO_MONO)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, audio, M_CFIFO_API_AUDIO_READ);
+
+  desc_count = m_cfifo_This_GetReadDescriptors(audio->cfifo, desc, 2);
+
+  for (uint8_t i = 0; i < desc_count && frames < max_frames; i++)
+  {
+    uint16_t run = desc[i].length / audio->frame_size;
+
+    if (run > max_frames - frames)
+      run = max_frames - frames;
+
+    m_cfifo_Audio_Convert(audio, desc[i].address, run, (uint8_t*)out, frames, max_frames, format, layout);
+    frames += run;
+  }
+
+  if (frames > 0 && !m_cfifo_This_ReadDone(audio->cfifo, frames * audio->frame_size))
+    return 0;
+
+  return frames;
+}
+
+uint16_t m_cfifo_Audio_GetFrames(m_cfifo_tAudio* audio)
+{
+  if (!audio)
+    return 0;
+
+  return m_cfifo_This_GetUsage(audio->cfifo) / audio->frame_size;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static inline uint8_t m_cfifo_Audio_SampleSize(m_cfifo_tAudioFormat format)
+{
+  return format == M_CFIFO_AUDIO_S16 ? 2 : 4;
+}
+
+static inline int32_t m_cfifo_Audio_Load(const uint8_t* src, m_cfifo_tAudioFormat format)
+{
+  if (format == M_CFIFO_AUDIO_S16)
+  {
+    int16_t s16;
+
+    memcpy(&s16, src, sizeof(s16));
+    return (int32_t)s16 * 65536;
+  }
+  else
+  {
+    int32_t s32;
+
+    memcpy(&s32, src, sizeof(s32));
+    return s32;
+  }
+}
+
+static inline void m_cfifo_Audio_Store(uint8_t* dst, int32_t sample, m_cfifo_tAudioFormat format)
+{
+  if (format == M_CFIFO_AUDIO_S16)
+  {
+    int16_t s16 = (int16_t)(sample >> 16);
+
+    memcpy(dst, &s16, sizeof(s16));
+  }
+  else
+  {
+    memcpy(dst, &sample, sizeof(sample));
+  }
+}
+
+static void m_cfifo_Audio_Convert(const m_cfifo_tAudio* audio, const uint8_t* src, uint16_t frames, uint8_t* out, uint16_t first, uint16_t max_frames, m_cfifo_tAudioFormat format, m_cfifo_tAudioLayout layout)
+{
+  const uint8_t in_size  = m_cfifo_Audio_SampleSize(audio->format);
+  const uint8_t out_size = m_cfifo_Audio_SampleSize(format);
+  const uint8_t channels = audio->channels;
+
+  switch (layout)
+  {
+    case M_CFIFO_AUDIO_INTERLEAVED:
+      if (format == audio->format)
+      {
+        memcpy(&out[(uint32_t)first * audio->frame_size], src, (uint32_t)frames * audio->frame_size);
+        break;
+      }
+
+      out = &out[(uint32_t)first * channels * out_size];
+
+      for (uint32_t i = 0; i < (uint32_t)frames * channels; i++)
+        m_cfifo_Audio_Store(&out[i * out_size], m_cfifo_Audio_Load(&src[i * in_size], audio->format), format);
+      break;
+
+    case M_CFIFO_AUDIO_PLANAR:
+      for (uint8_t c = 0; c < channels; c++)
+      {
+        uint8_t* plane = &out[((uint32_t)c * max_frames + first) * out_size];
+
+        for (uint16_t f = 0; f < frames; f++)
+          m_cfifo_Audio_Store(&plane[(uint32_t)f * out_size], m_cfifo_Audio_Load(&src[(uint32_t)f * audio->frame_size + c * in_size], audio->format), format);
+      }
+      break;
+
+    case M_CFIFO_AUDIO_MONO:
+      out = &out[(uint32_t)first * out_size];
+
+      for (uint16_t f = 0; f < frames; f++)
+      {
+        int64_t sum = 0;
+
+        for (uint8_t c = 0; c < channels; c++)
+          sum += m_cfifo_Audio_Load(&src[(uint32_t)f * audio->frame_size + c * in_size], audio->format);
+
+        m_cfifo_Audio_Store(&out[(uint32_t)f * out_size], (int32_t)(sum / channels), format);
+      }
+      break;
+  }
+}
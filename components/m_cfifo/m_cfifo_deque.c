@@ -0,0 +1,158 @@
+/**
+ * @file m_cfifo_deque.c
+ * @brief Implementation of the lock-free work-stealing deque.
+ *
+ * Design notes:
+ * - Bounded Chase-Lev deque. The owner publishes a pushed job with a
+ *   release store to `bottom`; thieves load `bottom` with acquire.
+ * - Owner pop first reserves the bottom slot by decrementing `bottom`,
+ *   then reads `top`. Both are sequentially consistent, as are the
+ *   thief's loads of `top` and `bottom`, so owner and thief cannot both
+ *   miss each other's claim on the last job. The last job is then
+ *   settled with a CAS on `top`, exactly like a steal.
+ * - The ring never grows; a slot is only reused after `top` has moved
+ *   past it, and a thief's stale `top` only makes push more cautious.
+ *
+ * @see m_cfifo_deque.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_deque.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Deque_Init(m_cfifo_tDeque* deque, void** slots, uint32_t capacity)
+{
+  if (!deque || !slots || capacity == 0 || (capacity & (capacity - 1)) != 0)
+    return false;
+
+  deque->slots  = slots;
+  deque->mask   = capacity - 1;
+  deque->bottom = 0;
+  deque->top    = 0;
+
+  return true;
+}
+
+bool m_cfifo_Deque_Push(m_cfifo_tDeque* deque, void* job)
+{
+  uint32_t bottom;
+  uint32_t top;
+
+  if (!deque)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, deque, M_CFIFO_API_DEQUE_PUSH);
+
+  bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+  top    = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+  if (bottom - top > deque->mask)
+    return false;
+
+  __atomic_store_n(&deque->slots[bottom & deque->mask], job, __ATOMIC_RELAXED);
+  __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+  M_CFIFO_TRACE(M_CFIFO_TRACE_PUSH, deque, 1);
+
+  return true;
+}
+
+bool m_cfifo_Deque_Pop(m_cfifo_tDeque* deque, void** job)
+{
+  uint32_t bottom;
+  uint32_t top;
+  bool res = true;
+
+  if (!deque || !job)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, deque, M_CFIFO_API_DEQUE_POP);
+
+  bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+  __atomic_store_n(&deque->bottom, bottom, __ATOMIC_SEQ_CST);
+  top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+
+  if ((int32_t)(bottom - top) < 0)
+  {
+    // empty, undo the reservation
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  *job = __atomic_load_n(&deque->slots[bottom & deque->mask], __ATOMIC_RELAXED);
+
+  if (bottom == top)
+  {
+    // last job, race against thieves
+    res = __atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+  }
+
+  if (res)
+    M_CFIFO_TRACE(M_CFIFO_TRACE_POP, deque, 1);
+
+  return res;
+}
+
+bool m_cfifo_Deque_Steal(m_cfifo_tDeque* deque, void** job)
+{
+  uint32_t bottom;
+  uint32_t top;
+  void* candidate;
+
+  if (!deque || !job)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, deque, M_CFIFO_API_DEQUE_STEAL);
+
+  top    = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+  bottom = __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+
+  if ((int32_t)(bottom - top) <= 0)
+    return false;
+
+  candidate = __atomic_load_n(&deque->slots[top & deque->mask], __ATOMIC_RELAXED);
+
+  if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    return false;
+
+  *job = candidate;
+  M_CFIFO_TRACE(M_CFIFO_TRACE_POP, deque, 1);
+  return true;
+}
+
+bool m_cfifo_Deque_StealAny(m_cfifo_tDeque* deques, uint8_t count, uint8_t self, uint8_t start, void** job)
+{
+  if (!deques || !job || count == 0)
+    return false;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t victim = (uint8_t)((start + i) % count);
+
+    if (victim != self && m_cfifo_Deque_Steal(&deques[victim], job))
+      return true;
+  }
+
+  return false;
+}
+
+uint32_t m_cfifo_Deque_GetUsage(m_cfifo_tDeque* deque)
+{
+  int32_t usage;
+
+  if (!deque)
+    return 0;
+
+  usage = (int32_t)(__atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE) - __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE));
+
+  return usage > 0 ? (uint32_t)usage : 0;
+}
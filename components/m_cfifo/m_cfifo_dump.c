@@ -0,0 +1,157 @@
+/**
+ * @file m_cfifo_dump.c
+ * @brief Implementation of the m_cfifo registry and introspection dump.
+ *
+ * Design notes:
+ * - The registry is a singly linked list through `registry_next`.
+ *   FIFOs are only ever pushed at the head with a release store, so a
+ *   reader that loaded the head sees a stable list behind it.
+ * - Registrations are serialized by a short critical section: the
+ *   duplicate scan and the push must be one step, otherwise two tasks
+ *   registering the same FIFO both link it, creating a self-loop.
+ * - Dumps read FIFO fields with relaxed atomic loads and never take a
+ *   FIFO lock. The lock state comes from the semaphore count.
+ *
+ * @see m_cfifo_dump.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_dump.h"
+#include <string.h>
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo* m_cfifo_registry = NULL;
+static portMUX_TYPE m_cfifo_registry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Takes a lock-free snapshot of a FIFO.
+ *
+ * @param cfifo  Pointer to the FIFO instance.
+ * @param record Receives the snapshot.
+ */
+static void m_cfifo_Dump_Snapshot(m_cfifo_tCFifo* cfifo, m_cfifo_tDumpRecord* record);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Register(m_cfifo_tCFifo* cfifo, const char* name)
+{
+  bool registered = false;
+
+  if (!cfifo)
+    return false;
+
+  __atomic_store_n(&cfifo->name, name, __ATOMIC_RELAXED);
+
+  taskENTER_CRITICAL(&m_cfifo_registry_lock);
+
+  for (m_cfifo_tCFifo* it = m_cfifo_registry; it != NULL && !registered; it = it->registry_next)
+    registered = it == cfifo;
+
+  if (!registered)
+  {
+    cfifo->registry_next = m_cfifo_registry;
+    __atomic_store_n(&m_cfifo_registry, cfifo, __ATOMIC_RELEASE);
+  }
+
+  taskEXIT_CRITICAL(&m_cfifo_registry_lock);
+
+  return true;
+}
+
+uint32_t m_cfifo_DumpAll(m_cfifo_tDumpPrintf out)
+{
+  m_cfifo_tDumpRecord record;
+  uint32_t count = 0;
+
+  if (!out)
+    return 0;
+
+  for (m_cfifo_tCFifo* it = __atomic_load_n(&m_cfifo_registry, __ATOMIC_ACQUIRE); it != NULL; it = it->registry_next)
+  {
+    m_cfifo_Dump_Snapshot(it, &record);
+
+    out("%-12.12s %08" PRIx32 " size %5u used %5u peak %5u rd %5u wr %5u prev %08" PRIx32 " next %08" PRIx32 " %s %s\n",
+        it->name ? it->name : "-", record.id,
+        record.buffer_size, record.used_count, record.peak_count, record.rdPtr, record.wrPtr,
+        record.prev, record.next,
+        record.lock_type == M_CFIFO_LOCK_TYPE_MUTEX ? "mutex" : "binary",
+        record.lock_held ? "held" : "free");
+    count++;
+  }
+
+  return count;
+}
+
+uint32_t m_cfifo_DumpAllBinary(m_cfifo_tDumpSink sink, void* ctx)
+{
+  m_cfifo_tDumpHeader header;
+  m_cfifo_tDumpRecord record;
+  m_cfifo_tCFifo* head;
+  uint32_t count = 0;
+
+  if (!sink)
+    return 0;
+
+  // the list behind a loaded head never changes, count it first
+  head = __atomic_load_n(&m_cfifo_registry, __ATOMIC_ACQUIRE);
+
+  for (m_cfifo_tCFifo* it = head; it != NULL; it = it->registry_next)
+    count++;
+
+  header.magic        = M_CFIFO_DUMP_MAGIC;
+  header.version      = M_CFIFO_DUMP_VERSION;
+  header.record_size  = sizeof(m_cfifo_tDumpRecord);
+  header.record_count = count;
+  sink(&header, sizeof(header), ctx);
+
+  for (m_cfifo_tCFifo* it = head; it != NULL; it = it->registry_next)
+  {
+    m_cfifo_Dump_Snapshot(it, &record);
+    sink(&record, sizeof(record), ctx);
+  }
+
+  return count;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void m_cfifo_Dump_Snapshot(m_cfifo_tCFifo* cfifo, m_cfifo_tDumpRecord* record)
+{
+  const char* name = __atomic_load_n(&cfifo->name, __ATOMIC_RELAXED);
+  SemaphoreHandle_t semaphore = __atomic_load_n(&cfifo->semaphore, __ATOMIC_RELAXED);
+
+  record->id          = (uint32_t)(uintptr_t)cfifo;
+  record->prev        = (uint32_t)(uintptr_t)__atomic_load_n(&cfifo->prev, __ATOMIC_RELAXED);
+  record->next        = (uint32_t)(uintptr_t)__atomic_load_n(&cfifo->next, __ATOMIC_RELAXED);
+  record->buffer_size = __atomic_load_n(&cfifo->buffer_size, __ATOMIC_RELAXED);
+  record->used_count  = __atomic_load_n(&cfifo->used_count, __ATOMIC_RELAXED);
+  record->peak_count  = __atomic_load_n(&cfifo->peak_count, __ATOMIC_RELAXED);
+  record->rdPtr       = __atomic_load_n(&cfifo->rdPtr, __ATOMIC_RELAXED);
+  record->wrPtr       = __atomic_load_n(&cfifo->wrPtr, __ATOMIC_RELAXED);
+  record->lock_type   = (uint8_t)cfifo->lock_type;
+  record->lock_held   = semaphore != NULL && uxSemaphoreGetCount(semaphore) == 0;
+
+  memset(record->name, 0, sizeof(record->name));
+
+  if (name != NULL)
+    memcpy(record->name, name, strnlen(name, sizeof(record->name)));
+}
@@ -0,0 +1,483 @@
+/**
+ * @file m_cfifo_mmap.c
+ * @brief Implementation of the memory-mapped m_cfifo file backing.
+ *
+ * Design notes:
+ * - The header occupies the whole first page so header and data can be
+ *   flushed separately with page-aligned msync calls.
+ * - With @ref M_CFIFO_MMAP_SYNC_FULL the data pages are flushed before
+ *   the header, so a header on disk never refers to unwritten data.
+ * - The state alternates between two header slots. Each slot is
+ *   published by writing its checksum last, behind a release fence, so
+ *   neither a torn write nor a concurrent reader can mistake a half
+ *   written slot for a commit.
+ * - A release rewrites the header from within the FIFO lock, combining
+ *   the new read position with the committed write position. A commit
+ *   takes its snapshot between two releases and advances it by the
+ *   releases that happened while it flushed, so an older snapshot never
+ *   resurrects released bytes.
+ *
+ * Only built for the Linux target.
+ *
+ * @see m_cfifo_mmap.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_mmap.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Checks whether the mapped header describes a usable FIFO file.
+ *
+ * @param header      Mapped header.
+ * @param data_offset Expected offset of the ring data.
+ * @param buffer_size Expected ring size.
+ *
+ * @retval true  Header is valid and matches the requested geometry.
+ * @retval false File must be reinitialized.
+ */
+static bool m_cfifo_Mmap_IsValid(const m_cfifo_tMmapHeader* header, uint16_t data_offset, uint16_t buffer_size);
+
+
+/**
+ * @brief Restores the FIFO from the newest header slot that is intact.
+ *
+ * @param mm Pointer to the handle.
+ *
+ * @retval true  FIFO state restored, `mm->sequence` continues from it.
+ * @retval false No slot holds a usable state.
+ */
+static bool m_cfifo_Mmap_Attach(m_cfifo_tMmap* mm);
+
+
+/**
+ * @brief Computes the checksum of a header slot.
+ *
+ * FNV-1a over all slot fields in front of `checksum`.
+ *
+ * @param slot Slot to check.
+ * @return Checksum value.
+ */
+static uint32_t m_cfifo_Mmap_Checksum(const m_cfifo_tMmapSlot* slot);
+
+
+/**
+ * @brief Writes a FIFO state snapshot into the next mapped header slot.
+ *
+ * @param mm    Pointer to the handle.
+ * @param state Snapshot to store.
+ */
+static void m_cfifo_Mmap_WriteHeader(m_cfifo_tMmap* mm, const m_cfifo_tState* state);
+
+
+/**
+ * @brief Flushes data and header according to a policy.
+ *
+ * @param mm     Pointer to the handle.
+ * @param policy Policy to apply.
+ *
+ * @retval true  msync calls succeeded.
+ * @retval false An msync call failed.
+ */
+static bool m_cfifo_Mmap_Flush(m_cfifo_tMmap* mm, m_cfifo_tMmapSync policy);
+
+
+/**
+ * @brief Writes the current FIFO state to the header.
+ *
+ * @param mm        Pointer to the handle.
+ * @param sync_data Flush the ring data synchronously before the header.
+ *
+ * @retval true  State written.
+ * @retval false State or data flush failed.
+ */
+static bool m_cfifo_Mmap_Persist(m_cfifo_tMmap* mm, bool sync_data);
+
+
+/**
+ * @brief Release hook, persists the new read position.
+ *
+ * @param state    FIFO state after the release.
+ * @param released Number of bytes released, 0 for a reset.
+ * @param arg      Pointer to the handle.
+ */
+static void m_cfifo_Mmap_OnRelease(const m_cfifo_tState* state, uint16_t released, void* arg);
+
+
+/**
+ * @brief Takes released bytes off the front of a persisted state.
+ *
+ * The write position is kept, bytes written after the state are not
+ * part of it.
+ *
+ * @param state    State to advance.
+ * @param released Number of bytes released.
+ * @param rdPtr    Read position after the release.
+ */
+static void m_cfifo_Mmap_Advance(m_cfifo_tState* state, uint32_t released, uint16_t rdPtr);
+
+
+/**
+ * @brief Detaches the FIFO, unmaps and closes the file without committing.
+ *
+ * @param mm Pointer to the handle.
+ *
+ * @retval true  munmap and close succeeded.
+ * @retval false One of them failed.
+ */
+static bool m_cfifo_Mmap_Release(m_cfifo_tMmap* mm);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Mmap_Open(m_cfifo_tMmap* mm, m_cfifo_tCFifo* cfifo, const char* path, uint16_t buffer_size, m_cfifo_tMmapSync policy, uint32_t sync_every)
+{
+  struct stat st;
+  long page_size = sysconf(_SC_PAGESIZE);
+  bool attach;
+
+  if (!mm || !cfifo || !path || buffer_size == 0 || page_size <= 0 || page_size > UINT16_MAX)
+    return false;
+
+  mm->cfifo              = cfifo;
+  mm->policy             = policy;
+  mm->sync_every         = sync_every == 0 ? 1 : sync_every;
+  mm->commits_since_sync = 0;
+  mm->sequence           = 0;
+  mm->map_size           = (size_t)page_size + buffer_size;
+
+  mm->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (mm->fd < 0)
+    return false;
+
+  if (fstat(mm->fd, &st) != 0 || ftruncate(mm->fd, (off_t)mm->map_size) != 0)
+  {
+    close(mm->fd);
+    return false;
+  }
+
+  mm->map = mmap(NULL, mm->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, mm->fd, 0);
+  if (mm->map == MAP_FAILED)
+  {
+    close(mm->fd);
+    return false;
+  }
+
+  mm->header   = (m_cfifo_tMmapHeader*)mm->map;
+  mm->lock     = xSemaphoreCreateMutex();
+  mm->released = 0;
+  mm->resets   = 0;
+  attach = (size_t)st.st_size == mm->map_size &&
+           m_cfifo_Mmap_IsValid(mm->header, (uint16_t)page_size, buffer_size);
+
+  if (mm->lock == NULL || !m_cfifo_ConfigBuffer(cfifo, mm->map + page_size, buffer_size))
+  {
+    m_cfifo_Mmap_Release(mm);
+    return false;
+  }
+
+  if (attach)
+    attach = m_cfifo_Mmap_Attach(mm);
+
+  if (!attach)
+  {
+    memset(mm->header, 0, (size_t)page_size);
+    mm->header->magic       = M_CFIFO_MMAP_MAGIC;
+    mm->header->version     = M_CFIFO_MMAP_VERSION;
+    mm->header->data_offset = (uint16_t)page_size;
+    mm->header->buffer_size = buffer_size;
+    mm->sequence            = 0;
+    m_cfifo_This_Clear(cfifo);
+  }
+
+  // from now on every release reaches the header
+  if (!m_cfifo_This_GetState(cfifo, &mm->persisted) ||
+      !m_cfifo_SetReleaseHook(cfifo, m_cfifo_Mmap_OnRelease, mm) ||
+      !m_cfifo_Mmap_Sync(mm))
+  {
+    m_cfifo_Mmap_Release(mm);
+    return false;
+  }
+
+  return true;
+}
+
+bool m_cfifo_Mmap_Commit(m_cfifo_tMmap* mm)
+{
+  bool flush;
+
+  if (!mm || !mm->header)
+    return false;
+
+  flush = ++mm->commits_since_sync >= mm->sync_every;
+
+  if (!m_cfifo_Mmap_Persist(mm, flush && mm->policy == M_CFIFO_MMAP_SYNC_FULL))
+    return false;
+
+  if (!flush)
+    return true;
+
+  mm->commits_since_sync = 0;
+  return m_cfifo_Mmap_Flush(mm, mm->policy);
+}
+
+bool m_cfifo_Mmap_Sync(m_cfifo_tMmap* mm)
+{
+  if (!mm || !mm->header)
+    return false;
+
+  if (!m_cfifo_Mmap_Persist(mm, true))
+    return false;
+
+  mm->commits_since_sync = 0;
+
+  return m_cfifo_Mmap_Flush(mm, M_CFIFO_MMAP_SYNC_FULL);
+}
+
+bool m_cfifo_Mmap_Close(m_cfifo_tMmap* mm)
+{
+  bool res = true;
+
+  if (!mm || !mm->header)
+    return false;
+
+  res = m_cfifo_Mmap_Commit(mm) && res;
+  res = m_cfifo_Mmap_Release(mm) && res;
+
+  return res;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static bool m_cfifo_Mmap_IsValid(const m_cfifo_tMmapHeader* header, uint16_t data_offset, uint16_t buffer_size)
+{
+  return header->magic == M_CFIFO_MMAP_MAGIC &&
+         header->version == M_CFIFO_MMAP_VERSION &&
+         header->data_offset == data_offset &&
+         header->buffer_size == buffer_size;
+}
+
+static bool m_cfifo_Mmap_Attach(m_cfifo_tMmap* mm)
+{
+  m_cfifo_tMmapSlot slots[2];
+  m_cfifo_tState state;
+  bool valid[2];
+  uint8_t newest;
+
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    uint32_t checksum = __atomic_load_n(&mm->header->slots[i].checksum, __ATOMIC_ACQUIRE);
+
+    slots[i] = mm->header->slots[i];
+    valid[i] = checksum == m_cfifo_Mmap_Checksum(&slots[i]) &&
+               (slots[i].sequence & 1) == i;
+  }
+
+  newest = valid[1] && (!valid[0] || (int32_t)(slots[1].sequence - slots[0].sequence) > 0) ? 1 : 0;
+
+  // newest first, then the commit before it
+  for (uint8_t k = 0; k < 2; k++)
+  {
+    uint8_t i = newest ^ k;
+
+    if (!valid[i])
+      continue;
+
+    state.buffer_size = mm->header->buffer_size;
+    state.used_count  = slots[i].used_count;
+    state.rdPtr       = slots[i].rdPtr;
+    state.wrPtr       = slots[i].wrPtr;
+    state.wrap_gap    = slots[i].wrap_gap;
+
+    if (m_cfifo_This_RestoreState(mm->cfifo, &state))
+    {
+      mm->sequence = slots[i].sequence;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static uint32_t m_cfifo_Mmap_Checksum(const m_cfifo_tMmapSlot* slot)
+{
+  const uint8_t* bytes = (const uint8_t*)slot;
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < offsetof(m_cfifo_tMmapSlot, checksum); i++)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+static void m_cfifo_Mmap_WriteHeader(m_cfifo_tMmap* mm, const m_cfifo_tState* state)
+{
+  m_cfifo_tMmapSlot slot;
+  m_cfifo_tMmapSlot* target;
+
+  mm->sequence++;
+  target = &mm->header->slots[mm->sequence & 1];
+
+  memset(&slot, 0, sizeof(slot));
+  slot.sequence   = mm->sequence;
+  slot.used_count = state->used_count;
+  slot.rdPtr      = state->rdPtr;
+  slot.wrPtr      = state->wrPtr;
+  slot.wrap_gap   = state->wrap_gap;
+  slot.checksum   = m_cfifo_Mmap_Checksum(&slot);
+
+  // invalidate, fill, then publish with the checksum
+  __atomic_store_n(&target->checksum, ~slot.checksum, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  target->sequence   = slot.sequence;
+  target->used_count = slot.used_count;
+  target->rdPtr      = slot.rdPtr;
+  target->wrPtr      = slot.wrPtr;
+  target->wrap_gap   = slot.wrap_gap;
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&target->checksum, slot.checksum, __ATOMIC_RELAXED);
+}
+
+static bool m_cfifo_Mmap_Flush(m_cfifo_tMmap* mm, m_cfifo_tMmapSync policy)
+{
+  switch (policy)
+  {
+    case M_CFIFO_MMAP_SYNC_ASYNC:
+      return msync(mm->map, mm->map_size, MS_ASYNC) == 0;
+
+    case M_CFIFO_MMAP_SYNC_FULL:
+      return msync(mm->map, mm->header->data_offset, MS_SYNC) == 0;
+
+    default:
+      return true;
+  }
+}
+
+static bool m_cfifo_Mmap_Persist(m_cfifo_tMmap* mm, bool sync_data)
+{
+  m_cfifo_tState state;
+  uint32_t released;
+  uint32_t resets;
+  bool stable;
+
+  // the snapshot must lie between two releases
+  do
+  {
+    xSemaphoreTake(mm->lock, portMAX_DELAY);
+    released = mm->released;
+    resets   = mm->resets;
+    xSemaphoreGive(mm->lock);
+
+    if (!m_cfifo_This_GetState(mm->cfifo, &state))
+      return false;
+
+    xSemaphoreTake(mm->lock, portMAX_DELAY);
+    stable = mm->released == released && mm->resets == resets;
+    xSemaphoreGive(mm->lock);
+  }while (!stable);
+
+  // data first, so the header on disk never runs ahead of it
+  if (sync_data && msync(mm->map + mm->header->data_offset, state.buffer_size, MS_SYNC) != 0)
+    return false;
+
+  xSemaphoreTake(mm->lock, portMAX_DELAY);
+
+  // a reset meanwhile replaced the content, keep what the hook stored
+  if (mm->resets == resets)
+  {
+    if (mm->released != released)
+      m_cfifo_Mmap_Advance(&state, mm->released - released, mm->persisted.rdPtr);
+
+    mm->persisted = state;
+  }
+
+  m_cfifo_Mmap_WriteHeader(mm, &mm->persisted);
+  xSemaphoreGive(mm->lock);
+
+  return true;
+}
+
+static void m_cfifo_Mmap_OnRelease(const m_cfifo_tState* state, uint16_t released, void* arg)
+{
+  m_cfifo_tMmap* mm = (m_cfifo_tMmap*)arg;
+
+  xSemaphoreTake(mm->lock, portMAX_DELAY);
+
+  if (released == 0)
+  {
+    mm->resets++;
+    mm->persisted = *state;
+  }
+  else
+  {
+    mm->released += released;
+    m_cfifo_Mmap_Advance(&mm->persisted, released, state->rdPtr);
+  }
+
+  m_cfifo_Mmap_WriteHeader(mm, &mm->persisted);
+
+  if (mm->policy == M_CFIFO_MMAP_SYNC_FULL)
+    msync(mm->map, mm->header->data_offset, MS_SYNC);
+
+  xSemaphoreGive(mm->lock);
+}
+
+static void m_cfifo_Mmap_Advance(m_cfifo_tState* state, uint32_t released, uint16_t rdPtr)
+{
+  state->rdPtr = rdPtr;
+
+  if (released >= state->used_count)
+  {
+    // only bytes written after the state were left
+    state->used_count = 0;
+    state->wrPtr      = rdPtr;
+    state->wrap_gap   = 0;
+    return;
+  }
+
+  state->used_count -= (uint16_t)released;
+  state->wrap_gap    = (uint16_t)(((uint32_t)state->wrPtr + state->buffer_size - rdPtr - state->used_count) % state->buffer_size);
+}
+
+static bool m_cfifo_Mmap_Release(m_cfifo_tMmap* mm)
+{
+  bool res = true;
+
+  m_cfifo_SetReleaseHook(mm->cfifo, NULL, NULL);
+  m_cfifo_ConfigBuffer(mm->cfifo, NULL, 0);
+
+  res = munmap(mm->map, mm->map_size) == 0 && res;
+  res = close(mm->fd) == 0 && res;
+
+  if (mm->lock != NULL)
+    vSemaphoreDelete(mm->lock);
+
+  mm->map    = NULL;
+  mm->header = NULL;
+  mm->fd     = -1;
+  mm->lock   = NULL;
+
+  return res;
+}
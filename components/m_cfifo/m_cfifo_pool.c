@@ -0,0 +1,219 @@
+/**
+ * @file m_cfifo_pool.c
+ * @brief Implementation of the arena-backed m_cfifo pool.
+ *
+ * Design notes:
+ * - The arena is split into control blocks, semaphore storage, slot
+ *   bookkeeping and data segments; no heap allocation takes place.
+ * - FIFOs and their semaphores are created once in @ref m_cfifo_Pool_Init
+ *   and only reset on acquire.
+ *
+ * @see m_cfifo_pool.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_pool.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define M_CFIFO_POOL_TIMEOUT 1000
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Swaps two entries of the slot permutation and updates the reverse map.
+ *
+ * @param pool Pointer to the pool instance.
+ * @param a    First position in `slots`.
+ * @param b    Second position in `slots`.
+ */
+static void m_cfifo_Pool_SwapSlots(m_cfifo_tPool* pool, uint16_t a, uint16_t b);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Pool_Init(m_cfifo_tPool* pool, void* arena, size_t arena_size, uint16_t segment_size, uint16_t count)
+{
+  uint8_t* cursor = (uint8_t*)arena;
+  StaticSemaphore_t* semaphore_buffers;
+
+  if (!pool || !arena || count == 0)
+    return false;
+
+  if (((uintptr_t)arena % M_CFIFO_POOL_ALIGNMENT) != 0)
+    return false;
+
+  if (arena_size < M_CFIFO_POOL_ARENA_SIZE(segment_size, count))
+    return false;
+
+  pool->fifos = (m_cfifo_tCFifo*)cursor;
+  cursor += M_CFIFO_POOL_ALIGN(sizeof(m_cfifo_tCFifo) * count);
+
+  semaphore_buffers = (StaticSemaphore_t*)cursor;
+  cursor += M_CFIFO_POOL_ALIGN(sizeof(StaticSemaphore_t) * count);
+
+  pool->slots   = (uint16_t*)cursor;
+  pool->slot_of = pool->slots + count;
+  cursor += M_CFIFO_POOL_ALIGN(2 * sizeof(uint16_t) * count);
+
+  pool->data         = cursor;
+  pool->segment_size = segment_size;
+  pool->count        = count;
+  pool->live_count   = 0;
+
+  pool->semaphore = xSemaphoreCreateBinaryStatic(&pool->semaphore_buffer);
+  if (pool->semaphore == NULL)
+    return false;
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    if (!m_cfifo_InitBufferStatic(&pool->fifos[i], &semaphore_buffers[i]))
+      return false;
+
+    if (!m_cfifo_ConfigBuffer(&pool->fifos[i], pool->data + (size_t)i * segment_size, segment_size))
+      return false;
+
+    pool->slots[i]   = i;
+    pool->slot_of[i] = i;
+  }
+
+  xSemaphoreGive(pool->semaphore);
+  return true;
+}
+
+m_cfifo_tCFifo* m_cfifo_Pool_Acquire(m_cfifo_tPool* pool)
+{
+  m_cfifo_tCFifo* cfifo = NULL;
+
+  if (!pool)
+    return NULL;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, pool, M_CFIFO_API_POOL_ACQUIRE);
+
+  if (xSemaphoreTake(pool->semaphore, M_CFIFO_POOL_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+    return NULL;
+
+  if (pool->live_count < pool->count)
+  {
+    cfifo = &pool->fifos[pool->slots[pool->live_count]];
+    pool->live_count++;
+  }
+
+  xSemaphoreGive(pool->semaphore);
+
+  if (cfifo != NULL)
+  {
+    m_cfifo_tLockStats lock_stats;
+    size_t index = (size_t)(cfifo - pool->fifos);
+
+    // a resize by the previous owner swapped the buffer, take the segment back
+    m_cfifo_ConfigBuffer(cfifo, pool->data + index * pool->segment_size, pool->segment_size);
+
+    // nothing of the previous owner's configuration may leak into the new one
+    cfifo->prev = NULL;
+    cfifo->next = NULL;
+    m_cfifo_SetDummyByte(cfifo, 0x00);
+    m_cfifo_SetRateLimit(cfifo, NULL, 0, 0, 0);
+    m_cfifo_SetLatencyHistogram(cfifo, NULL, 0);
+    m_cfifo_SetReleaseHook(cfifo, NULL, NULL);
+    m_cfifo_SetLockPolicy(cfifo, M_CFIFO_LOCK_BLOCK);
+    m_cfifo_GetLockStats(cfifo, &lock_stats, true);
+    m_cfifo_This_Clear(cfifo);
+    m_cfifo_SetStreamOffset(cfifo, 0);
+    m_cfifo_This_GetPeak(cfifo, true);
+  }
+
+  return cfifo;
+}
+
+bool m_cfifo_Pool_Release(m_cfifo_tPool* pool, m_cfifo_tCFifo* cfifo)
+{
+  uint16_t index;
+  bool res = false;
+
+  if (!pool || !cfifo)
+    return false;
+
+  if (cfifo < pool->fifos || cfifo >= pool->fifos + pool->count)
+    return false;
+
+  index = (uint16_t)(cfifo - pool->fifos);
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, pool, M_CFIFO_API_POOL_RELEASE);
+
+  if (xSemaphoreTake(pool->semaphore, M_CFIFO_POOL_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+    return false;
+
+  if (pool->slot_of[index] < pool->live_count)
+  {
+    pool->live_count--;
+    m_cfifo_Pool_SwapSlots(pool, pool->slot_of[index], pool->live_count);
+    res = true;
+  }
+
+  xSemaphoreGive(pool->semaphore);
+  return res;
+}
+
+uint16_t m_cfifo_Pool_GetLiveCount(m_cfifo_tPool* pool)
+{
+  uint16_t res = 0;
+
+  if (!pool)
+    return res;
+
+  if (xSemaphoreTake(pool->semaphore, M_CFIFO_POOL_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+    return res;
+
+  res = pool->live_count;
+
+  xSemaphoreGive(pool->semaphore);
+  return res;
+}
+
+uint16_t m_cfifo_Pool_ForEach(m_cfifo_tPool* pool, m_cfifo_tPoolVisitor visitor, void* ctx)
+{
+  uint16_t visited = 0;
+
+  if (!pool || !visitor)
+    return visited;
+
+  if (xSemaphoreTake(pool->semaphore, M_CFIFO_POOL_TIMEOUT / portTICK_PERIOD_MS) == pdFALSE)
+    return visited;
+
+  for (visited = 0; visited < pool->live_count; visited++)
+    visitor(&pool->fifos[pool->slots[visited]], ctx);
+
+  xSemaphoreGive(pool->semaphore);
+  return visited;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void m_cfifo_Pool_SwapSlots(m_cfifo_tPool* pool, uint16_t a, uint16_t b)
+{
+  uint16_t index_a = pool->slots[a];
+  uint16_t index_b = pool->slots[b];
+
+  pool->slots[a] = index_b;
+  pool->slots[b] = index_a;
+  pool->slot_of[index_b] = a;
+  pool->slot_of[index_a] = b;
+}
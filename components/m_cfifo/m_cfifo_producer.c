@@ -0,0 +1,183 @@
+/**
+ * @file m_cfifo_producer.c
+ * @brief Implementation of the write-combining m_cfifo producer.
+ *
+ * Design notes:
+ * - Staged bytes are published with @ref m_cfifo_This_PushBlock, i.e. one
+ *   lock acquisition per publish instead of one per byte.
+ * - The deadline is measured from the oldest staged byte and is only
+ *   evaluated on producer calls; there is no background timer.
+ *
+ * @see m_cfifo_producer.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_producer.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+#include <string.h>
+#include "freertos/task.h"
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Checks whether the oldest staged byte has reached its deadline.
+ *
+ * @param producer Pointer to the producer handle.
+ *
+ * @retval true  Staged data must be published.
+ * @retval false Staging is empty or the deadline has not expired.
+ */
+static bool m_cfifo_Producer_IsDue(m_cfifo_tProducer* producer);
+
+
+/**
+ * @brief Stages bytes and publishes full or due staging buffers.
+ *
+ * @param producer Pointer to the producer handle.
+ * @param data     Bytes to write.
+ * @param length   Number of bytes.
+ *
+ * @return Number of bytes accepted.
+ */
+static uint16_t m_cfifo_Producer_WriteInternal(m_cfifo_tProducer* producer, const uint8_t* data, uint16_t length);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Producer_Init(m_cfifo_tProducer* producer, m_cfifo_tCFifo* cfifo, uint8_t* staging, uint16_t staging_size, TickType_t max_latency)
+{
+  if (!producer || !cfifo || !staging || staging_size == 0)
+    return false;
+
+  producer->cfifo             = cfifo;
+  producer->staging           = staging;
+  producer->staging_size      = staging_size;
+  producer->staged            = 0;
+  producer->max_latency       = max_latency;
+  producer->first_staged_tick = 0;
+
+  return true;
+}
+
+bool m_cfifo_Producer_Push(m_cfifo_tProducer* producer, uint8_t data)
+{
+  if (!producer)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, producer, M_CFIFO_API_PRODUCER_PUSH);
+  return m_cfifo_Producer_WriteInternal(producer, &data, 1) == 1;
+}
+
+uint16_t m_cfifo_Producer_Write(m_cfifo_tProducer* producer, const uint8_t* data, uint16_t length)
+{
+  if (!producer || !data)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, producer, M_CFIFO_API_PRODUCER_WRITE);
+  return m_cfifo_Producer_WriteInternal(producer, data, length);
+}
+
+bool m_cfifo_Producer_Flush(m_cfifo_tProducer* producer)
+{
+  uint16_t published;
+
+  if (!producer)
+    return false;
+
+  if (producer->staged == 0)
+    return true;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, producer, M_CFIFO_API_PRODUCER_FLUSH);
+  published = m_cfifo_This_PushBlock(producer->cfifo, producer->staging, producer->staged);
+
+  if (published > 0 && published < producer->staged)
+    memmove(producer->staging, &producer->staging[published], producer->staged - published);
+
+  // the deadline of the remaining bytes keeps running from the oldest byte
+  producer->staged -= published;
+
+  return producer->staged == 0;
+}
+
+bool m_cfifo_Producer_Poll(m_cfifo_tProducer* producer)
+{
+  if (!producer)
+    return false;
+
+  if (m_cfifo_Producer_IsDue(producer))
+    return m_cfifo_Producer_Flush(producer);
+
+  return producer->staged == 0;
+}
+
+uint16_t m_cfifo_Producer_GetStaged(m_cfifo_tProducer* producer)
+{
+  if (!producer)
+    return 0;
+
+  return producer->staged;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static bool m_cfifo_Producer_IsDue(m_cfifo_tProducer* producer)
+{
+  if (producer->staged == 0)
+    return false;
+
+  if (producer->max_latency == portMAX_DELAY)
+    return false;
+
+  return (TickType_t)(xTaskGetTickCount() - producer->first_staged_tick) >= producer->max_latency;
+}
+
+static uint16_t m_cfifo_Producer_WriteInternal(m_cfifo_tProducer* producer, const uint8_t* data, uint16_t length)
+{
+  uint16_t accepted = 0;
+
+  while (accepted < length)
+  {
+    uint16_t chunk = producer->staging_size - producer->staged;
+
+    if (chunk == 0)
+    {
+      m_cfifo_Producer_Flush(producer);
+
+      // FIFO could not take anything, keep the rest with the caller
+      if (producer->staged == producer->staging_size)
+        break;
+
+      continue;
+    }
+
+    if (chunk > length - accepted)
+      chunk = length - accepted;
+
+    if (producer->staged == 0)
+      producer->first_staged_tick = xTaskGetTickCount();
+
+    memcpy(&producer->staging[producer->staged], &data[accepted], chunk);
+    producer->staged += chunk;
+    accepted += chunk;
+  }
+
+  if (producer->staged == producer->staging_size || m_cfifo_Producer_IsDue(producer))
+    m_cfifo_Producer_Flush(producer);
+
+  return accepted;
+}
+
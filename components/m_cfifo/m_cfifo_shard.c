@@ -0,0 +1,116 @@
+/**
+ * @file m_cfifo_shard.c
+ * @brief Implementation of the sharded m_cfifo.
+ *
+ * Design notes:
+ * - Each shard keeps its own semaphore; a producer only locks the shard
+ *   of its core, the consumer locks one shard per pop.
+ * - `usage` is increased before a push (and corrected for bytes that
+ *   did not fit) and decreased after a pop. It may briefly overstate the
+ *   shard contents, which only costs the consumer a futile pass, but it
+ *   never wraps below zero.
+ *
+ * @see m_cfifo_shard.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_shard.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Shard_Init(m_cfifo_tShard* shard, m_cfifo_tCFifo* const* fifos, uint8_t count)
+{
+  uint32_t usage = 0;
+
+  if (!shard || !fifos || count == 0 || count > M_CFIFO_SHARD_MAX)
+    return false;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (fifos[i] == NULL)
+      return false;
+
+    shard->shards[i] = fifos[i];
+    usage += m_cfifo_This_GetUsage(fifos[i]);
+  }
+
+  shard->count  = count;
+  shard->cursor = 0;
+  shard->usage  = usage;
+
+  return true;
+}
+
+uint16_t m_cfifo_Shard_Push(m_cfifo_tShard* shard, const uint8_t* data, uint16_t length)
+{
+  if (!shard)
+    return 0;
+
+  return m_cfifo_Shard_PushTo(shard, (uint8_t)(xPortGetCoreID() % shard->count), data, length);
+}
+
+uint16_t m_cfifo_Shard_PushTo(m_cfifo_tShard* shard, uint8_t index, const uint8_t* data, uint16_t length)
+{
+  uint16_t pushed;
+
+  if (!shard || !data || index >= shard->count)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, shard, M_CFIFO_API_SHARD_PUSH_TO);
+
+  // count first, so a racing pop can never drive the counter below zero
+  __atomic_add_fetch(&shard->usage, length, __ATOMIC_RELEASE);
+  pushed = m_cfifo_This_PushBlock(shard->shards[index], data, length);
+
+  if (pushed < length)
+    __atomic_sub_fetch(&shard->usage, length - pushed, __ATOMIC_RELEASE);
+
+  return pushed;
+}
+
+uint16_t m_cfifo_Shard_Pop(m_cfifo_tShard* shard, uint8_t* data, uint16_t length, uint8_t* index)
+{
+  if (!shard || !data || length == 0)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, shard, M_CFIFO_API_SHARD_POP);
+
+  // nothing anywhere: skip all shard locks
+  if (__atomic_load_n(&shard->usage, __ATOMIC_ACQUIRE) == 0)
+    return 0;
+
+  for (uint8_t i = 0; i < shard->count; i++)
+  {
+    uint8_t current = (uint8_t)((shard->cursor + i) % shard->count);
+    uint16_t popped = m_cfifo_This_PopBlock(shard->shards[current], data, length);
+
+    if (popped > 0)
+    {
+      __atomic_sub_fetch(&shard->usage, popped, __ATOMIC_RELEASE);
+      shard->cursor = (uint8_t)((current + 1) % shard->count);
+
+      if (index != NULL)
+        *index = current;
+
+      return popped;
+    }
+  }
+
+  return 0;
+}
+
+uint32_t m_cfifo_Shard_GetUsage(m_cfifo_tShard* shard)
+{
+  if (!shard)
+    return 0;
+
+  return __atomic_load_n(&shard->usage, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,413 @@
+/**
+ * @file m_cfifo_shm.c
+ * @brief Implementation of the cross-process shared memory SPSC FIFO.
+ *
+ * Design notes:
+ * - `wrCount` is only written by the producer, `rdCount` only by the
+ *   consumer. Data is published with a store to the own counter after
+ *   the memcpy; the other side loads it before touching the data.
+ * - Sleeping uses a Dekker-style handshake: the waiter sets its flag and
+ *   re-checks the counter before `FUTEX_WAIT`, the other side publishes
+ *   its counter and then checks the flag. Both use sequentially
+ *   consistent atomics, so a wake-up cannot be lost.
+ * - Shared futexes (no FUTEX_PRIVATE_FLAG) work across processes.
+ *
+ * Only built for the Linux target.
+ *
+ * @see m_cfifo_shm.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_shm.h"
+#include "m_cfifo_trace.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define M_CFIFO_SHM_FOREVER UINT32_MAX
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Maps a shared memory object and fills in the handle.
+ *
+ * @param handle   Pointer to the handle.
+ * @param map_size Size of the object in bytes.
+ *
+ * @retval true  Mapping established.
+ * @retval false mmap failed.
+ */
+static bool m_cfifo_Shm_Map(m_cfifo_tShm* handle, size_t map_size);
+
+
+/**
+ * @brief Sleeps until @p word differs from @p observed or the time is up.
+ *
+ * @param word       Futex word (counter of the other side).
+ * @param waiting    Waiter flag of the calling side.
+ * @param observed   Counter value seen by the caller.
+ * @param timeout_ms Maximum time to sleep.
+ *
+ * @retval true  Counter may have changed.
+ * @retval false Timeout expired.
+ */
+static bool m_cfifo_Shm_Wait(uint32_t* word, uint32_t* waiting, uint32_t observed, uint32_t timeout_ms);
+
+
+/**
+ * @brief Wakes the other side if it is flagged as waiting.
+ *
+ * @param word    Futex word the other side sleeps on.
+ * @param waiting Waiter flag of the other side.
+ */
+static void m_cfifo_Shm_Wake(uint32_t* word, uint32_t* waiting);
+
+
+/**
+ * @brief Milliseconds left until an absolute monotonic deadline.
+ *
+ * @param deadline Deadline from CLOCK_MONOTONIC.
+ * @return Remaining milliseconds, 0 if expired.
+ */
+static uint32_t m_cfifo_Shm_Remaining(const struct timespec* deadline);
+
+
+/**
+ * @brief Computes an absolute monotonic deadline.
+ *
+ * @param deadline   Output deadline.
+ * @param timeout_ms Relative timeout.
+ */
+static void m_cfifo_Shm_Deadline(struct timespec* deadline, uint32_t timeout_ms);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Shm_Create(m_cfifo_tShm* handle, const char* name, uint32_t buffer_size)
+{
+  size_t map_size;
+
+  if (!handle || !name || buffer_size == 0 || (buffer_size & (buffer_size - 1)) != 0)
+    return false;
+
+  map_size = sizeof(m_cfifo_tShmFifo) + buffer_size;
+
+  handle->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (handle->fd < 0)
+    return false;
+
+  if (ftruncate(handle->fd, (off_t)map_size) != 0 || !m_cfifo_Shm_Map(handle, map_size))
+  {
+    close(handle->fd);
+    shm_unlink(name);
+    return false;
+  }
+
+  memset(handle->shm, 0, sizeof(m_cfifo_tShmFifo));
+  handle->shm->version     = M_CFIFO_SHM_VERSION;
+  handle->shm->buffer_size = buffer_size;
+  handle->shm->data_offset = sizeof(m_cfifo_tShmFifo);
+  handle->buffer           = (uint8_t*)handle->shm + handle->shm->data_offset;
+  handle->buffer_size      = buffer_size;
+
+  // magic last: an opener never sees a half initialized block
+  __atomic_store_n(&handle->shm->magic, M_CFIFO_SHM_MAGIC, __ATOMIC_RELEASE);
+
+  return true;
+}
+
+bool m_cfifo_Shm_Open(m_cfifo_tShm* handle, const char* name)
+{
+  struct stat st;
+  m_cfifo_tShmFifo* shm;
+
+  if (!handle || !name)
+    return false;
+
+  handle->fd = shm_open(name, O_RDWR, 0600);
+  if (handle->fd < 0)
+    return false;
+
+  if (fstat(handle->fd, &st) != 0 || (size_t)st.st_size < sizeof(m_cfifo_tShmFifo) ||
+      !m_cfifo_Shm_Map(handle, (size_t)st.st_size))
+  {
+    close(handle->fd);
+    return false;
+  }
+
+  shm = handle->shm;
+
+  // the peer's header is untrusted: masks need a power of two, and the
+  // data must not overlap the counters
+  if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != M_CFIFO_SHM_MAGIC ||
+      shm->version != M_CFIFO_SHM_VERSION ||
+      shm->buffer_size == 0 || (shm->buffer_size & (shm->buffer_size - 1)) != 0 ||
+      shm->data_offset < sizeof(m_cfifo_tShmFifo) ||
+      (size_t)shm->data_offset + shm->buffer_size > handle->map_size)
+  {
+    m_cfifo_Shm_Close(handle);
+    return false;
+  }
+
+  handle->buffer      = (uint8_t*)shm + shm->data_offset;
+  handle->buffer_size = shm->buffer_size;
+  return true;
+}
+
+bool m_cfifo_Shm_Close(m_cfifo_tShm* handle)
+{
+  bool res = true;
+
+  if (!handle || !handle->shm)
+    return false;
+
+  res = munmap(handle->shm, handle->map_size) == 0 && res;
+  res = close(handle->fd) == 0 && res;
+
+  handle->shm         = NULL;
+  handle->buffer      = NULL;
+  handle->buffer_size = 0;
+  handle->fd          = -1;
+
+  return res;
+}
+
+bool m_cfifo_Shm_Unlink(const char* name)
+{
+  if (!name)
+    return false;
+
+  return shm_unlink(name) == 0;
+}
+
+uint32_t m_cfifo_Shm_Write(m_cfifo_tShm* handle, const uint8_t* data, uint32_t length, uint32_t timeout_ms)
+{
+  struct timespec deadline;
+  uint32_t written = 0;
+
+  if (!handle || !handle->shm || !data)
+    return written;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, handle, M_CFIFO_API_SHM_WRITE);
+
+  m_cfifo_tShmFifo* shm = handle->shm;
+  uint32_t size = handle->buffer_size;
+  uint32_t wr   = shm->wrCount;
+
+  m_cfifo_Shm_Deadline(&deadline, timeout_ms);
+
+  while (written < length)
+  {
+    uint32_t rd = __atomic_load_n(&shm->rdCount, __ATOMIC_ACQUIRE);
+    uint32_t free_space;
+
+    // corrupted counters, copying would run past the ring
+    if (wr - rd > size)
+      break;
+
+    free_space = size - (wr - rd);
+
+    if (free_space == 0)
+    {
+      uint32_t remaining = timeout_ms == M_CFIFO_SHM_FOREVER ? M_CFIFO_SHM_FOREVER : m_cfifo_Shm_Remaining(&deadline);
+      bool woken;
+
+      if (remaining == 0)
+        break;
+
+      M_CFIFO_TRACE(M_CFIFO_TRACE_BLOCK, handle, M_CFIFO_API_SHM_WRITE);
+      woken = m_cfifo_Shm_Wait(&shm->rdCount, &shm->wr_waiting, rd, remaining);
+      M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, handle, M_CFIFO_API_SHM_WRITE);
+
+      if (!woken)
+        break;
+
+      continue;
+    }
+
+    if (free_space > length - written)
+      free_space = length - written;
+
+    uint32_t offset = wr & (size - 1);
+    uint32_t chunk  = size - offset;
+
+    if (chunk > free_space)
+      chunk = free_space;
+
+    memcpy(&handle->buffer[offset], &data[written], chunk);
+    memcpy(handle->buffer, &data[written + chunk], free_space - chunk);
+
+    written += free_space;
+    wr      += free_space;
+    __atomic_store_n(&shm->wrCount, wr, __ATOMIC_SEQ_CST);
+    M_CFIFO_TRACE(M_CFIFO_TRACE_PUSH, handle, free_space > UINT16_MAX ? UINT16_MAX : free_space);
+    m_cfifo_Shm_Wake(&shm->wrCount, &shm->rd_waiting);
+  }
+
+  return written;
+}
+
+uint32_t m_cfifo_Shm_Read(m_cfifo_tShm* handle, uint8_t* data, uint32_t length, uint32_t timeout_ms)
+{
+  struct timespec deadline;
+  uint32_t available;
+
+  if (!handle || !handle->shm || !data || length == 0)
+    return 0;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, handle, M_CFIFO_API_SHM_READ);
+
+  m_cfifo_tShmFifo* shm = handle->shm;
+  uint32_t size = handle->buffer_size;
+  uint32_t rd   = shm->rdCount;
+
+  m_cfifo_Shm_Deadline(&deadline, timeout_ms);
+
+  for (;;)
+  {
+    uint32_t wr = __atomic_load_n(&shm->wrCount, __ATOMIC_ACQUIRE);
+
+    available = wr - rd;
+    if (available > 0)
+      break;
+
+    uint32_t remaining = timeout_ms == M_CFIFO_SHM_FOREVER ? M_CFIFO_SHM_FOREVER : m_cfifo_Shm_Remaining(&deadline);
+    bool woken;
+
+    if (remaining == 0)
+      return 0;
+
+    M_CFIFO_TRACE(M_CFIFO_TRACE_BLOCK, handle, M_CFIFO_API_SHM_READ);
+    woken = m_cfifo_Shm_Wait(&shm->wrCount, &shm->rd_waiting, wr, remaining);
+    M_CFIFO_TRACE(M_CFIFO_TRACE_WAKE, handle, M_CFIFO_API_SHM_READ);
+
+    if (!woken)
+      return 0;
+  }
+
+  // corrupted counters, copying would run past the ring
+  if (available > size)
+    return 0;
+
+  if (available > length)
+    available = length;
+
+  uint32_t offset = rd & (size - 1);
+  uint32_t chunk  = size - offset;
+
+  if (chunk > available)
+    chunk = available;
+
+  memcpy(data, &handle->buffer[offset], chunk);
+  memcpy(&data[chunk], handle->buffer, available - chunk);
+
+  __atomic_store_n(&shm->rdCount, rd + available, __ATOMIC_SEQ_CST);
+  M_CFIFO_TRACE(M_CFIFO_TRACE_POP, handle, available > UINT16_MAX ? UINT16_MAX : available);
+  m_cfifo_Shm_Wake(&shm->rdCount, &shm->wr_waiting);
+
+  return available;
+}
+
+uint32_t m_cfifo_Shm_GetUsage(m_cfifo_tShm* handle)
+{
+  if (!handle || !handle->shm)
+    return 0;
+
+  return __atomic_load_n(&handle->shm->wrCount, __ATOMIC_ACQUIRE) -
+         __atomic_load_n(&handle->shm->rdCount, __ATOMIC_ACQUIRE);
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static bool m_cfifo_Shm_Map(m_cfifo_tShm* handle, size_t map_size)
+{
+  void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd, 0);
+
+  if (map == MAP_FAILED)
+    return false;
+
+  handle->shm      = (m_cfifo_tShmFifo*)map;
+  handle->map_size = map_size;
+  return true;
+}
+
+static bool m_cfifo_Shm_Wait(uint32_t* word, uint32_t* waiting, uint32_t observed, uint32_t timeout_ms)
+{
+  struct timespec timeout;
+  long res;
+
+  __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(word, __ATOMIC_SEQ_CST) != observed)
+  {
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+    return true;
+  }
+
+  timeout.tv_sec  = timeout_ms / 1000;
+  timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+
+  res = syscall(SYS_futex, word, FUTEX_WAIT, observed,
+                timeout_ms == M_CFIFO_SHM_FOREVER ? NULL : &timeout, NULL, 0);
+
+  __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+
+  return !(res != 0 && errno == ETIMEDOUT);
+}
+
+static void m_cfifo_Shm_Wake(uint32_t* word, uint32_t* waiting)
+{
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST) == 0)
+    return;
+
+  __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+  syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static uint32_t m_cfifo_Shm_Remaining(const struct timespec* deadline)
+{
+  struct timespec now;
+  int64_t remaining_ms;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  remaining_ms = (int64_t)(deadline->tv_sec - now.tv_sec) * 1000 +
+                 (deadline->tv_nsec - now.tv_nsec) / 1000000;
+
+  return remaining_ms > 0 ? (uint32_t)remaining_ms : 0;
+}
+
+static void m_cfifo_Shm_Deadline(struct timespec* deadline, uint32_t timeout_ms)
+{
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  deadline->tv_sec  += timeout_ms / 1000;
+  deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+
+  if (deadline->tv_nsec >= 1000000000L)
+  {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
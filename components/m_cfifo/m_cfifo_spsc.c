@@ -0,0 +1,321 @@
+/**
+ * @file m_cfifo_spsc.c
+ * @brief Implementation of the lock-free SPSC m_cfifo cascade.
+ *
+ * Design notes:
+ * - `wrPtr` is published by the producer with release semantics after
+ *   the data bytes; the consumer loads it with acquire semantics.
+ *   `rdPtr` is handled symmetrically to return free space.
+ * - A segment gets a successor only when it is full, and the producer
+ *   never writes to it afterwards. Once the consumer sees `next`, the
+ *   remaining content of the segment is final.
+ * - The spare pool is a Treiber stack. Only the producer pops from it,
+ *   so ABA cannot occur.
+ *
+ * @see m_cfifo_spsc.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_spsc.h"
+#include "m_cfifo_trace.h"
+#include <stddef.h>
+#include <string.h>
+
+
+//*****************************************************************************
+// Local Function Prototypes
+//*****************************************************************************
+
+/**
+ * @brief Resets a segment to an empty, unlinked SPSC ring.
+ *
+ * @param segment Pointer to the segment.
+ */
+static void m_cfifo_Spsc_ResetSegment(m_cfifo_tCFifo* segment);
+
+
+/**
+ * @brief Pushes a drained or new segment onto the spare pool.
+ *
+ * @param spsc    Pointer to the SPSC cascade.
+ * @param segment Segment to release.
+ */
+static void m_cfifo_Spsc_ReleaseSegment(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment);
+
+
+/**
+ * @brief Producer: appends a spare segment behind the current tail.
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @return The new tail segment, or NULL if the pool is empty.
+ */
+static m_cfifo_tCFifo* m_cfifo_Spsc_Grow(m_cfifo_tSpsc* spsc);
+
+
+/**
+ * @brief Consumer: returns the first segment holding data.
+ *
+ * Drained segments with a published successor are retired on the way.
+ *
+ * @param spsc Pointer to the SPSC cascade.
+ * @return Segment with at least one byte, or NULL if the cascade is empty.
+ */
+static m_cfifo_tCFifo* m_cfifo_Spsc_ConsumerSegment(m_cfifo_tSpsc* spsc);
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+bool m_cfifo_Spsc_Init(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment, uint8_t* buffer, uint16_t buffer_size)
+{
+  if (!spsc || !segment || !buffer || buffer_size < 2)
+    return false;
+
+  segment->buffer      = buffer;
+  segment->buffer_size = buffer_size;
+  segment->dummy_byte  = 0x00;
+  segment->semaphore   = NULL;
+  m_cfifo_Spsc_ResetSegment(segment);
+
+  spsc->head      = segment;
+  spsc->tail      = segment;
+  spsc->free_list = NULL;
+
+  return true;
+}
+
+bool m_cfifo_Spsc_AddSegment(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment, uint8_t* buffer, uint16_t buffer_size)
+{
+  if (!spsc || !segment || !buffer || buffer_size < 2)
+    return false;
+
+  segment->buffer      = buffer;
+  segment->buffer_size = buffer_size;
+  segment->dummy_byte  = 0x00;
+  segment->semaphore   = NULL;
+
+  m_cfifo_Spsc_ReleaseSegment(spsc, segment);
+  return true;
+}
+
+bool m_cfifo_Spsc_Push(m_cfifo_tSpsc* spsc, uint8_t data)
+{
+  m_cfifo_tCFifo* segment;
+  uint16_t wr;
+  uint16_t wr_next;
+
+  if (!spsc)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, spsc, M_CFIFO_API_SPSC_PUSH);
+
+  segment = spsc->tail;
+  wr      = segment->wrPtr;
+  wr_next = (wr + 1) % segment->buffer_size;
+
+  if (wr_next == __atomic_load_n(&segment->rdPtr, __ATOMIC_ACQUIRE))
+  {
+    segment = m_cfifo_Spsc_Grow(spsc);
+    if (segment == NULL)
+      return false;
+
+    wr      = 0;
+    wr_next = 1;
+  }
+
+  segment->buffer[wr] = data;
+  __atomic_store_n(&segment->wrPtr, wr_next, __ATOMIC_RELEASE);
+  M_CFIFO_TRACE(M_CFIFO_TRACE_PUSH, spsc, 1);
+
+  return true;
+}
+
+uint32_t m_cfifo_Spsc_Write(m_cfifo_tSpsc* spsc, const uint8_t* data, uint32_t length)
+{
+  uint32_t written = 0;
+
+  if (!spsc || !data)
+    return written;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, spsc, M_CFIFO_API_SPSC_WRITE);
+
+  m_cfifo_tCFifo* segment = spsc->tail;
+
+  while (written < length)
+  {
+    uint16_t wr   = segment->wrPtr;
+    uint16_t rd   = __atomic_load_n(&segment->rdPtr, __ATOMIC_ACQUIRE);
+    uint16_t size = segment->buffer_size;
+    uint32_t free_space = (uint32_t)(rd + size - wr - 1) % size;
+
+    if (free_space == 0)
+    {
+      segment = m_cfifo_Spsc_Grow(spsc);
+      if (segment == NULL)
+        break;
+
+      continue;
+    }
+
+    if (free_space > length - written)
+      free_space = length - written;
+
+    uint32_t chunk = size - wr;
+
+    if (chunk > free_space)
+      chunk = free_space;
+
+    memcpy(&segment->buffer[wr], &data[written], chunk);
+    memcpy(segment->buffer, &data[written + chunk], free_space - chunk);
+
+    written += free_space;
+    __atomic_store_n(&segment->wrPtr, (uint16_t)((wr + free_space) % size), __ATOMIC_RELEASE);
+    M_CFIFO_TRACE(M_CFIFO_TRACE_PUSH, spsc, free_space);
+  }
+
+  return written;
+}
+
+bool m_cfifo_Spsc_Pop(m_cfifo_tSpsc* spsc, uint8_t* data)
+{
+  m_cfifo_tCFifo* segment;
+  uint16_t rd;
+
+  if (!spsc || !data)
+    return false;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, spsc, M_CFIFO_API_SPSC_POP);
+
+  segment = m_cfifo_Spsc_ConsumerSegment(spsc);
+  if (segment == NULL)
+    return false;
+
+  rd    = segment->rdPtr;
+  *data = segment->buffer[rd];
+  __atomic_store_n(&segment->rdPtr, (uint16_t)((rd + 1) % segment->buffer_size), __ATOMIC_RELEASE);
+  M_CFIFO_TRACE(M_CFIFO_TRACE_POP, spsc, 1);
+
+  return true;
+}
+
+uint32_t m_cfifo_Spsc_Read(m_cfifo_tSpsc* spsc, uint8_t* data, uint32_t length)
+{
+  uint32_t read = 0;
+
+  if (!spsc || !data)
+    return read;
+
+  M_CFIFO_TRACE(M_CFIFO_TRACE_CALL, spsc, M_CFIFO_API_SPSC_READ);
+
+  while (read < length)
+  {
+    m_cfifo_tCFifo* segment = m_cfifo_Spsc_ConsumerSegment(spsc);
+    if (segment == NULL)
+      break;
+
+    uint16_t rd   = segment->rdPtr;
+    uint16_t wr   = __atomic_load_n(&segment->wrPtr, __ATOMIC_ACQUIRE);
+    uint16_t size = segment->buffer_size;
+    uint32_t available = (uint32_t)(wr + size - rd) % size;
+
+    if (available > length - read)
+      available = length - read;
+
+    uint32_t chunk = size - rd;
+
+    if (chunk > available)
+      chunk = available;
+
+    memcpy(&data[read], &segment->buffer[rd], chunk);
+    memcpy(&data[read + chunk], segment->buffer, available - chunk);
+
+    read += available;
+    __atomic_store_n(&segment->rdPtr, (uint16_t)((rd + available) % size), __ATOMIC_RELEASE);
+    M_CFIFO_TRACE(M_CFIFO_TRACE_POP, spsc, available);
+  }
+
+  return read;
+}
+
+bool m_cfifo_Spsc_IsEmpty(m_cfifo_tSpsc* spsc)
+{
+  if (!spsc)
+    return true;
+
+  return m_cfifo_Spsc_ConsumerSegment(spsc) == NULL;
+}
+
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void m_cfifo_Spsc_ResetSegment(m_cfifo_tCFifo* segment)
+{
+  segment->prev       = NULL;
+  segment->next       = NULL;
+  segment->rdPtr      = 0;
+  segment->wrPtr      = 0;
+  segment->used_count = 0;
+}
+
+static void m_cfifo_Spsc_ReleaseSegment(m_cfifo_tSpsc* spsc, m_cfifo_tCFifo* segment)
+{
+  m_cfifo_tCFifo* head = __atomic_load_n(&spsc->free_list, __ATOMIC_RELAXED);
+
+  do
+  {
+    segment->next = head;
+  } while (!__atomic_compare_exchange_n(&spsc->free_list, &head, segment, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static m_cfifo_tCFifo* m_cfifo_Spsc_Grow(m_cfifo_tSpsc* spsc)
+{
+  m_cfifo_tCFifo* segment = __atomic_load_n(&spsc->free_list, __ATOMIC_ACQUIRE);
+
+  while (segment != NULL &&
+         !__atomic_compare_exchange_n(&spsc->free_list, &segment, segment->next, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+  {
+  }
+
+  if (segment == NULL)
+    return NULL;
+
+  m_cfifo_Spsc_ResetSegment(segment);
+  segment->prev = spsc->tail;
+
+  __atomic_store_n(&spsc->tail->next, segment, __ATOMIC_RELEASE);
+  spsc->tail = segment;
+
+  return segment;
+}
+
+static m_cfifo_tCFifo* m_cfifo_Spsc_ConsumerSegment(m_cfifo_tSpsc* spsc)
+{
+  m_cfifo_tCFifo* segment = spsc->head;
+
+  for (;;)
+  {
+    if (segment->rdPtr != __atomic_load_n(&segment->wrPtr, __ATOMIC_ACQUIRE))
+      return segment;
+
+    m_cfifo_tCFifo* next = __atomic_load_n(&segment->next, __ATOMIC_ACQUIRE);
+    if (next == NULL)
+      return NULL;
+
+    // the producer may have completed the segment before linking `next`
+    if (segment->rdPtr != __atomic_load_n(&segment->wrPtr, __ATOMIC_ACQUIRE))
+      return segment;
+
+    next->prev = NULL;
+    spsc->head = next;
+    m_cfifo_Spsc_ReleaseSegment(spsc, segment);
+    segment = next;
+  }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file m_cfifo_trace.c
+ * @brief Implementation of the m_cfifo trace ring.
+ *
+ * Design notes:
+ * - Writers claim a slot with an atomic fetch-and-add on a free-running
+ *   index; the ring size is a power of two so the slot is a mask away.
+ * - Events are not published atomically as a whole. A dump taken while
+ *   recording may contain a partially written event; pause recording
+ *   with @ref m_cfifo_Trace_Enable for an exact snapshot.
+ *
+ * @see m_cfifo_trace.h
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "m_cfifo_trace.h"
+
+#ifdef CONFIG_M_CFIFO_TRACE
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define M_CFIFO_TRACE_RING_SIZE CONFIG_M_CFIFO_TRACE_RING_SIZE
+#define M_CFIFO_TRACE_RING_MASK (M_CFIFO_TRACE_RING_SIZE - 1)
+
+_Static_assert((M_CFIFO_TRACE_RING_SIZE & M_CFIFO_TRACE_RING_MASK) == 0,
+               "CONFIG_M_CFIFO_TRACE_RING_SIZE must be a power of two");
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tTraceEvent m_cfifo_trace_ring[M_CFIFO_TRACE_RING_SIZE];
+static uint32_t m_cfifo_trace_head;
+static bool m_cfifo_trace_enabled = true;
+
+
+
+//*****************************************************************************
+// Global Functions
+//*****************************************************************************
+
+void m_cfifo_Trace_Record(m_cfifo_tTraceType type, const void* cfifo, uint16_t arg)
+{
+  m_cfifo_tTraceEvent* event;
+  uint32_t index;
+
+  if (!__atomic_load_n(&m_cfifo_trace_enabled, __ATOMIC_RELAXED))
+    return;
+
+  index = __atomic_fetch_add(&m_cfifo_trace_head, 1, __ATOMIC_RELAXED);
+  event = &m_cfifo_trace_ring[index & M_CFIFO_TRACE_RING_MASK];
+
+  event->timestamp = (uint64_t)esp_timer_get_time();
+  event->fifo      = (uint32_t)(uintptr_t)cfifo;
+  event->task      = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+  event->arg       = arg;
+  event->type      = (uint8_t)type;
+  event->core      = (uint8_t)xPortGetCoreID();
+}
+
+void m_cfifo_Trace_TaskSwitchedIn(void)
+{
+  m_cfifo_Trace_Record(M_CFIFO_TRACE_TASK_SWITCH, NULL, 0);
+}
+
+void m_cfifo_Trace_Enable(bool enable)
+{
+  __atomic_store_n(&m_cfifo_trace_enabled, enable, __ATOMIC_RELAXED);
+}
+
+void m_cfifo_Trace_Reset(void)
+{
+  __atomic_store_n(&m_cfifo_trace_head, 0, __ATOMIC_RELAXED);
+}
+
+uint32_t m_cfifo_Trace_Dump(m_cfifo_tTraceSink sink, void* ctx)
+{
+  m_cfifo_tTraceHeader header;
+  uint32_t head;
+  uint32_t first;
+
+  if (!sink)
+    return 0;
+
+  head  = __atomic_load_n(&m_cfifo_trace_head, __ATOMIC_ACQUIRE);
+  first = head > M_CFIFO_TRACE_RING_SIZE ? head - M_CFIFO_TRACE_RING_SIZE : 0;
+
+  header.magic       = M_CFIFO_TRACE_MAGIC;
+  header.version     = M_CFIFO_TRACE_VERSION;
+  header.event_size  = sizeof(m_cfifo_tTraceEvent);
+  header.event_count = head - first;
+  sink(&header, sizeof(header), ctx);
+
+  for (uint32_t i = first; i < head; i++)
+    sink(&m_cfifo_trace_ring[i & M_CFIFO_TRACE_RING_MASK], sizeof(m_cfifo_tTraceEvent), ctx);
+
+  return head - first;
+}
+
+#endif /* CONFIG_M_CFIFO_TRACE */
@@ -0,0 +1,20 @@
+/**
+ * @file test_app_main.c
+ * @brief Runs all m_cfifo test cases.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "unity.h"
+#include "unity_test_runner.h"
+
+
+void app_main(void)
+{
+  UNITY_BEGIN();
+  unity_run_all_tests();
+  UNITY_END();
+}
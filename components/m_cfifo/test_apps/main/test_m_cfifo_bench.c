@@ -0,0 +1,168 @@
+/**
+ * @file test_m_cfifo_bench.c
+ * @brief Micro benchmarks of the FIFO fast paths.
+ *
+ * Each benchmark checks that the compared paths produce the same data
+ * and prints the cost per operation, measured with esp_timer. The
+ * numbers are informational; only correctness is asserted, so the
+ * cases also pass on a loaded CI host.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "esp_timer.h"
+#include "m_cfifo.h"
+#include "m_cfifo_typed.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_BENCH_CAPACITY 256
+#define TEST_BENCH_ROUNDS   2000
+
+#define TEST_BENCH_SEARCH_SIZE   4096
+#define TEST_BENCH_SEARCH_ROUNDS 200
+
+M_CFIFO_DECLARE(test_bench_typed, uint8_t, TEST_BENCH_CAPACITY)
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static test_bench_typed_tFifo test_bench_typed;
+static m_cfifo_tCFifo test_bench_cfifo;
+static uint8_t test_bench_buffer[TEST_BENCH_CAPACITY];
+static uint8_t test_bench_search_buffer[TEST_BENCH_SEARCH_SIZE];
+static uint8_t test_bench_search_linear[TEST_BENCH_SEARCH_SIZE];
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void test_bench_Report(const char* name, int64_t elapsed_us, uint32_t ops)
+{
+  printf("%-32s %8lld us  %6lu ns/op\n", name, (long long)elapsed_us,
+         (unsigned long)(elapsed_us * 1000 / ops));
+}
+
+
+static bool test_bench_FindByteLoop(const uint8_t* data, uint16_t length, const uint8_t* pattern, uint16_t pattern_length, uint16_t* offset)
+{
+  for (uint16_t i = 0; i + pattern_length <= length; i++)
+  {
+    uint16_t k = 0;
+
+    while (k < pattern_length && data[i + k] == pattern[k])
+      k++;
+
+    if (k == pattern_length)
+    {
+      *offset = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("bench typed FIFO against m_cfifo_This_Push/Pop", "[m_cfifo][bench]")
+{
+  const uint32_t ops = TEST_BENCH_ROUNDS * TEST_BENCH_CAPACITY;
+  uint32_t sum_typed = 0;
+  uint32_t sum_cfifo = 0;
+  int64_t start;
+  uint8_t data;
+
+  TEST_ASSERT_TRUE(test_bench_typed_Init(&test_bench_typed));
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_bench_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_bench_cfifo, test_bench_buffer, sizeof(test_bench_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_bench_cfifo));
+
+  // fill completely and drain, so both paths wrap on every round
+  start = esp_timer_get_time();
+  for (uint32_t round = 0; round < TEST_BENCH_ROUNDS; round++)
+  {
+    for (uint32_t i = 0; i < TEST_BENCH_CAPACITY; i++)
+      test_bench_typed_Push(&test_bench_typed, (uint8_t)(round + i));
+    while (test_bench_typed_Pop(&test_bench_typed, &data))
+      sum_typed += data;
+  }
+  test_bench_Report("typed Push/Pop", esp_timer_get_time() - start, ops);
+
+  start = esp_timer_get_time();
+  for (uint32_t round = 0; round < TEST_BENCH_ROUNDS; round++)
+  {
+    for (uint32_t i = 0; i < TEST_BENCH_CAPACITY; i++)
+      m_cfifo_This_Push(&test_bench_cfifo, (uint8_t)(round + i));
+    while (m_cfifo_This_Pop(&test_bench_cfifo, &data))
+      sum_cfifo += data;
+  }
+  test_bench_Report("m_cfifo_This_Push/Pop", esp_timer_get_time() - start, ops);
+
+  TEST_ASSERT_EQUAL_UINT32(sum_typed, sum_cfifo);
+  TEST_ASSERT_TRUE(m_cfifo_This_IsEmpty(&test_bench_cfifo));
+
+  vSemaphoreDelete(test_bench_cfifo.semaphore);
+  vSemaphoreDelete(test_bench_typed.semaphore);
+}
+
+TEST_CASE("bench m_cfifo_This_FindPattern against a byte loop", "[m_cfifo][bench]")
+{
+  static const uint8_t sync[] = {0x2D, 0xD4, 0x2B, 0xB4};
+  static const uint8_t noise[] = {0x2D, 0x2D, 0xD4, 0x2B};
+  const uint16_t used = TEST_BENCH_SEARCH_SIZE - 16;
+  uint16_t offset_find = 0;
+  uint16_t offset_loop = 0;
+  bool found_find = false;
+  bool found_loop = false;
+  int64_t start;
+  uint8_t data;
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_bench_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_bench_cfifo, test_bench_search_buffer, sizeof(test_bench_search_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_bench_cfifo));
+
+  // move the read pointer so the content wraps in the middle
+  for (uint16_t i = 0; i < TEST_BENCH_SEARCH_SIZE / 2; i++)
+    m_cfifo_This_Push(&test_bench_cfifo, 0);
+  for (uint16_t i = 0; i < TEST_BENCH_SEARCH_SIZE / 2; i++)
+    m_cfifo_This_Pop(&test_bench_cfifo, &data);
+
+  // half of the bytes are the first sync byte and every fourth starts a
+  // three byte partial match, only the tail matches in full: worst case
+  // for the first-byte prefilter, reported per search over the content
+  for (uint16_t i = 0; i < used - sizeof(sync); i++)
+    test_bench_search_linear[i] = noise[i % sizeof(noise)];
+  memcpy(&test_bench_search_linear[used - sizeof(sync)], sync, sizeof(sync));
+  TEST_ASSERT_EQUAL_UINT16(used, m_cfifo_This_PushBlock(&test_bench_cfifo, test_bench_search_linear, used));
+
+  start = esp_timer_get_time();
+  for (uint32_t round = 0; round < TEST_BENCH_SEARCH_ROUNDS; round++)
+    found_find = m_cfifo_This_FindPattern(&test_bench_cfifo, sync, sizeof(sync), &offset_find);
+  test_bench_Report("m_cfifo_This_FindPattern", esp_timer_get_time() - start, TEST_BENCH_SEARCH_ROUNDS);
+
+  start = esp_timer_get_time();
+  for (uint32_t round = 0; round < TEST_BENCH_SEARCH_ROUNDS; round++)
+    found_loop = test_bench_FindByteLoop(test_bench_search_linear, used, sync, sizeof(sync), &offset_loop);
+  test_bench_Report("byte loop (linear copy)", esp_timer_get_time() - start, TEST_BENCH_SEARCH_ROUNDS);
+
+  TEST_ASSERT_TRUE(found_find);
+  TEST_ASSERT_TRUE(found_loop);
+  TEST_ASSERT_EQUAL_UINT16(used - sizeof(sync), offset_loop);
+  TEST_ASSERT_EQUAL_UINT16(offset_loop, offset_find);
+
+  vSemaphoreDelete(test_bench_cfifo.semaphore);
+}
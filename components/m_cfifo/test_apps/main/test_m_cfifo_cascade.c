@@ -0,0 +1,121 @@
+/**
+ * @file test_m_cfifo_cascade.c
+ * @brief Randomized check of the cascade-wide block push and pop.
+ *
+ * Two cascades of odd-sized segments get the same random steps: one
+ * through @ref m_cfifo_All_PushBlock / @ref m_cfifo_All_PopBlock, the
+ * other through repeated @ref m_cfifo_All_Push / @ref m_cfifo_All_Pop.
+ * Popped bytes and the fill level of every segment must stay identical,
+ * while blocks cross segment boundaries and the segments wrap.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_CASCADE_SEGMENTS 3
+#define TEST_CASCADE_MAX_LEN  80
+#define TEST_CASCADE_STEPS    20000
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static const uint16_t test_cascade_sizes[TEST_CASCADE_SEGMENTS] = {17, 31, 23};
+static m_cfifo_tCFifo test_cascade_block[TEST_CASCADE_SEGMENTS];
+static m_cfifo_tCFifo test_cascade_byte[TEST_CASCADE_SEGMENTS];
+static uint8_t test_cascade_block_buffer[TEST_CASCADE_SEGMENTS][32];
+static uint8_t test_cascade_byte_buffer[TEST_CASCADE_SEGMENTS][32];
+static uint32_t test_cascade_seed = 0x1B873593u;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static uint32_t test_cascade_Random(void)
+{
+  // xorshift32, fixed seed so failures reproduce
+  test_cascade_seed ^= test_cascade_seed << 13;
+  test_cascade_seed ^= test_cascade_seed >> 17;
+  test_cascade_seed ^= test_cascade_seed << 5;
+  return test_cascade_seed;
+}
+
+static void test_cascade_Build(m_cfifo_tCFifo* cascade, uint8_t (*buffers)[32])
+{
+  for (uint8_t i = 0; i < TEST_CASCADE_SEGMENTS; i++)
+  {
+    TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&cascade[i]));
+    TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&cascade[i], buffers[i], test_cascade_sizes[i]));
+    TEST_ASSERT_TRUE(m_cfifo_This_Clear(&cascade[i]));
+
+    if (i > 0)
+      TEST_ASSERT_TRUE(m_cfifo_CascadeAsNextBuffer(&cascade[i - 1], &cascade[i]));
+  }
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("All_PushBlock/All_PopBlock match byte-wise All_Push/All_Pop", "[m_cfifo][cascade]")
+{
+  uint8_t data[TEST_CASCADE_MAX_LEN];
+  uint8_t block[TEST_CASCADE_MAX_LEN];
+  uint8_t bytes[TEST_CASCADE_MAX_LEN];
+
+  test_cascade_Build(test_cascade_block, test_cascade_block_buffer);
+  test_cascade_Build(test_cascade_byte, test_cascade_byte_buffer);
+
+  for (uint32_t step = 0; step < TEST_CASCADE_STEPS; step++)
+  {
+    uint32_t length = test_cascade_Random() % (TEST_CASCADE_MAX_LEN + 1);
+    uint32_t expected = 0;
+    uint32_t count;
+
+    if (test_cascade_Random() & 1)
+    {
+      for (uint32_t i = 0; i < length; i++)
+        data[i] = (uint8_t)test_cascade_Random();
+
+      count = m_cfifo_All_PushBlock(test_cascade_block, data, length);
+
+      while (expected < length && m_cfifo_All_Push(test_cascade_byte, data[expected]))
+        expected++;
+
+      TEST_ASSERT_EQUAL_UINT32(expected, count);
+    }
+    else
+    {
+      count = m_cfifo_All_PopBlock(test_cascade_block, block, length);
+
+      while (expected < length && m_cfifo_All_Pop(test_cascade_byte, &bytes[expected]))
+        expected++;
+
+      TEST_ASSERT_EQUAL_UINT32(expected, count);
+      if (count > 0)
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes, block, count);
+    }
+
+    // same segment fill, not just the same total
+    for (uint8_t i = 0; i < TEST_CASCADE_SEGMENTS; i++)
+      TEST_ASSERT_EQUAL_UINT16(m_cfifo_This_GetUsage(&test_cascade_byte[i]), m_cfifo_This_GetUsage(&test_cascade_block[i]));
+  }
+
+  for (uint8_t i = 0; i < TEST_CASCADE_SEGMENTS; i++)
+  {
+    vSemaphoreDelete(test_cascade_block[i].semaphore);
+    vSemaphoreDelete(test_cascade_byte[i].semaphore);
+  }
+}
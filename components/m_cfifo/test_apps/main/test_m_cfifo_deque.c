@@ -0,0 +1,129 @@
+/**
+ * @file test_m_cfifo_deque.c
+ * @brief Stress test of the Chase-Lev work-stealing deque.
+ *
+ * The test task owns the deque and pushes and pops jobs in random
+ * bursts, so the last job is contested often, while thief tasks steal
+ * concurrently. Every job must be taken exactly once.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "m_cfifo_deque.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_DEQUE_JOBS     50000
+#define TEST_DEQUE_CAPACITY 16
+#define TEST_DEQUE_THIEVES  2
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tDeque test_deque;
+static void* test_deque_slots[TEST_DEQUE_CAPACITY];
+static uint8_t test_deque_taken[TEST_DEQUE_JOBS];
+static uint32_t test_deque_total;
+static bool test_deque_stop;
+static SemaphoreHandle_t test_deque_done;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void test_deque_Take(void* job)
+{
+  __atomic_add_fetch((uint8_t*)job, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&test_deque_total, 1, __ATOMIC_RELAXED);
+}
+
+static void test_deque_thief(void* arg)
+{
+  void* job;
+
+  (void)arg;
+
+  while (!__atomic_load_n(&test_deque_stop, __ATOMIC_ACQUIRE))
+  {
+    if (m_cfifo_Deque_Steal(&test_deque, &job))
+      test_deque_Take(job);
+    else
+      taskYIELD();
+  }
+
+  xSemaphoreGive(test_deque_done);
+  vTaskDelete(NULL);
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("deque hands every job out exactly once under concurrent steals", "[m_cfifo][deque][stress]")
+{
+  uint32_t seed = 0x9E3779B9u;
+  uint32_t pushed = 0;
+  void* job;
+
+  test_deque_done  = xSemaphoreCreateCounting(TEST_DEQUE_THIEVES, 0);
+  test_deque_total = 0;
+  test_deque_stop  = false;
+  TEST_ASSERT_NOT_NULL(test_deque_done);
+  TEST_ASSERT_TRUE(m_cfifo_Deque_Init(&test_deque, test_deque_slots, TEST_DEQUE_CAPACITY));
+
+  for (uint8_t i = 0; i < TEST_DEQUE_THIEVES; i++)
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_deque_thief, "deque_thief", 4096, NULL, uxTaskPriorityGet(NULL), NULL));
+
+  while (pushed < TEST_DEQUE_JOBS)
+  {
+    uint32_t burst;
+
+    seed = seed * 1664525u + 1013904223u;
+    burst = 1 + (seed >> 24) % TEST_DEQUE_CAPACITY;
+
+    for (uint32_t i = 0; i < burst && pushed < TEST_DEQUE_JOBS; i++)
+    {
+      if (!m_cfifo_Deque_Push(&test_deque, &test_deque_taken[pushed]))
+        break;
+      pushed++;
+    }
+
+    // pop a random share back, down to an empty deque now and then
+    burst = (seed >> 16) % (TEST_DEQUE_CAPACITY + 2);
+
+    for (uint32_t i = 0; i < burst && m_cfifo_Deque_Pop(&test_deque, &job); i++)
+      test_deque_Take(job);
+  }
+
+  while (m_cfifo_Deque_Pop(&test_deque, &job))
+    test_deque_Take(job);
+
+  // let thieves finish the jobs they stole last
+  TEST_ASSERT_EQUAL_UINT32(0, m_cfifo_Deque_GetUsage(&test_deque));
+  for (TickType_t start = xTaskGetTickCount();
+       __atomic_load_n(&test_deque_total, __ATOMIC_RELAXED) < TEST_DEQUE_JOBS &&
+       xTaskGetTickCount() - start < pdMS_TO_TICKS(1000);)
+    taskYIELD();
+
+  __atomic_store_n(&test_deque_stop, true, __ATOMIC_RELEASE);
+  for (uint8_t i = 0; i < TEST_DEQUE_THIEVES; i++)
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_deque_done, pdMS_TO_TICKS(1000)));
+
+  TEST_ASSERT_EQUAL_UINT32(TEST_DEQUE_JOBS, test_deque_total);
+  for (uint32_t i = 0; i < TEST_DEQUE_JOBS; i++)
+    TEST_ASSERT_EQUAL_UINT8(1, test_deque_taken[i]);
+
+  vSemaphoreDelete(test_deque_done);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_m_cfifo_grant.c
+ * @brief Write grants completed from ISRs and aborted grants.
+ *
+ * Commits from interrupt context only mark a grant as done; the data
+ * must stay invisible until a task-context call publishes it, and then
+ * appear in grant order. The region of an aborted older grant is never
+ * published, the aborted newest grant is dropped.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_GRANT_FIFO_SIZE 64
+#define TEST_GRANT_LENGTH    8
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_grant_cfifo;
+static uint8_t test_grant_buffer[TEST_GRANT_FIFO_SIZE];
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static uint8_t* test_grant_Fill(uint8_t* grant_id, uint8_t value)
+{
+  uint8_t* region = m_cfifo_This_Grant(&test_grant_cfifo, TEST_GRANT_LENGTH, grant_id);
+
+  TEST_ASSERT_NOT_NULL(region);
+  memset(region, value, TEST_GRANT_LENGTH);
+
+  return region;
+}
+
+static void test_grant_Expect(uint8_t value)
+{
+  uint8_t data[TEST_GRANT_LENGTH];
+
+  TEST_ASSERT_EQUAL_UINT16(TEST_GRANT_LENGTH, m_cfifo_This_PopBlock(&test_grant_cfifo, data, sizeof(data)));
+  for (uint8_t i = 0; i < TEST_GRANT_LENGTH; i++)
+    TEST_ASSERT_EQUAL_UINT8(value, data[i]);
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("grants committed from ISRs are published in order by task context", "[m_cfifo][grant]")
+{
+  uint8_t id_a, id_b;
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_grant_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_grant_cfifo, test_grant_buffer, sizeof(test_grant_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_grant_cfifo));
+
+  test_grant_Fill(&id_a, 0xA0);
+  test_grant_Fill(&id_b, 0xB0);
+
+  TEST_ASSERT_TRUE(m_cfifo_This_CommitFromISR(&test_grant_cfifo, id_b, TEST_GRANT_LENGTH));
+  TEST_ASSERT_FALSE(m_cfifo_This_CommitFromISR(&test_grant_cfifo, id_b, TEST_GRANT_LENGTH));
+  TEST_ASSERT_FALSE(m_cfifo_This_CommitFromISR(&test_grant_cfifo, id_a, TEST_GRANT_LENGTH - 1));
+  TEST_ASSERT_TRUE(m_cfifo_This_CommitFromISR(&test_grant_cfifo, id_a, TEST_GRANT_LENGTH));
+
+  // marked only, nothing visible before a task-context call
+  TEST_ASSERT_EQUAL_UINT16(0, m_cfifo_This_GetUsage(&test_grant_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_This_PublishGrants(&test_grant_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(2 * TEST_GRANT_LENGTH, m_cfifo_This_GetUsage(&test_grant_cfifo));
+
+  test_grant_Expect(0xA0);
+  test_grant_Expect(0xB0);
+
+  vSemaphoreDelete(test_grant_cfifo.semaphore);
+}
+
+TEST_CASE("aborted grants are skipped or dropped", "[m_cfifo][grant]")
+{
+  uint8_t head[4] = {0x55, 0x55, 0x55, 0x55};
+  uint8_t id_a, id_b, id_c;
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_grant_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_grant_cfifo, test_grant_buffer, sizeof(test_grant_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_grant_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(sizeof(head), m_cfifo_This_PushBlock(&test_grant_cfifo, head, sizeof(head)));
+
+  test_grant_Fill(&id_a, 0xA0);
+  test_grant_Fill(&id_b, 0xB0);
+  test_grant_Fill(&id_c, 0xC0);
+
+  // a failed older transfer holds back the newer data, the newest is dropped
+  TEST_ASSERT_TRUE(m_cfifo_This_Commit(&test_grant_cfifo, id_b, TEST_GRANT_LENGTH));
+  TEST_ASSERT_TRUE(m_cfifo_This_Abort(&test_grant_cfifo, id_a));
+  TEST_ASSERT_FALSE(m_cfifo_This_Abort(&test_grant_cfifo, id_a));
+  TEST_ASSERT_TRUE(m_cfifo_This_Abort(&test_grant_cfifo, id_c));
+  TEST_ASSERT_EQUAL_UINT16(sizeof(head), m_cfifo_This_GetUsage(&test_grant_cfifo));
+
+  // reading up to the aborted region skips it and publishes the next grant
+  TEST_ASSERT_EQUAL_UINT16(sizeof(head), m_cfifo_This_PopBlock(&test_grant_cfifo, head, sizeof(head)));
+  TEST_ASSERT_EQUAL_UINT16(TEST_GRANT_LENGTH, m_cfifo_This_GetUsage(&test_grant_cfifo));
+
+  test_grant_Expect(0xB0);
+  TEST_ASSERT_TRUE(m_cfifo_This_IsEmpty(&test_grant_cfifo));
+
+  vSemaphoreDelete(test_grant_cfifo.semaphore);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_m_cfifo_lock.c
+ * @brief Priority inversion test of the mutex lock type.
+ *
+ * Classic inversion setup on one core: a low-priority task holds the
+ * FIFO lock, a medium-priority task hogs the CPU and a high-priority
+ * task pushes into the FIFO. With @ref M_CFIFO_LOCK_TYPE_MUTEX the
+ * holder inherits the waiter's priority and finishes its critical
+ * section, so the push completes after about the hold time instead of
+ * waiting for the hog.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "unity.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_LOCK_HOLD_US     20000
+#define TEST_LOCK_MAX_WAIT_US 100000
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_lock_cfifo;
+static uint8_t test_lock_buffer[16];
+static SemaphoreHandle_t test_lock_held;
+static SemaphoreHandle_t test_lock_done;
+static bool test_lock_stop;
+static bool test_lock_pushed;
+static int64_t test_lock_wait_us;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void test_lock_Busy(int64_t duration_us)
+{
+  int64_t start = esp_timer_get_time();
+
+  while (esp_timer_get_time() - start < duration_us)
+    ;
+}
+
+static void test_lock_holder(void* arg)
+{
+  (void)arg;
+
+  // hold the FIFO lock the way m_cfifo_Lock does
+  xSemaphoreTake(test_lock_cfifo.semaphore, portMAX_DELAY);
+  xSemaphoreGive(test_lock_held);
+  test_lock_Busy(TEST_LOCK_HOLD_US);
+  xSemaphoreGive(test_lock_cfifo.semaphore);
+
+  xSemaphoreGive(test_lock_done);
+  vTaskDelete(NULL);
+}
+
+static void test_lock_hog(void* arg)
+{
+  (void)arg;
+
+  while (!__atomic_load_n(&test_lock_stop, __ATOMIC_ACQUIRE))
+    ;
+
+  xSemaphoreGive(test_lock_done);
+  vTaskDelete(NULL);
+}
+
+static void test_lock_waiter(void* arg)
+{
+  int64_t start = esp_timer_get_time();
+
+  (void)arg;
+
+  test_lock_pushed  = m_cfifo_This_Push(&test_lock_cfifo, 0x42);
+  test_lock_wait_us = esp_timer_get_time() - start;
+
+  xSemaphoreGive(test_lock_done);
+  vTaskDelete(NULL);
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("mutex lock bounds the wait of a high-priority task under inversion", "[m_cfifo][lock]")
+{
+  UBaseType_t base = uxTaskPriorityGet(NULL);
+  BaseType_t core = xPortGetCoreID();
+  bool finished;
+
+  test_lock_held = xSemaphoreCreateBinary();
+  test_lock_done = xSemaphoreCreateCounting(3, 0);
+  test_lock_stop = false;
+  TEST_ASSERT_NOT_NULL(test_lock_held);
+  TEST_ASSERT_NOT_NULL(test_lock_done);
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBufferLock(&test_lock_cfifo, M_CFIFO_LOCK_TYPE_MUTEX, NULL));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_lock_cfifo, test_lock_buffer, sizeof(test_lock_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_lock_cfifo));
+
+  // the test task stays above all three so it can orchestrate and stop the hog
+  vTaskPrioritySet(NULL, base + 4);
+
+  TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_lock_holder, "lock_low", 4096, NULL, base + 1, NULL, core));
+  TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_lock_held, pdMS_TO_TICKS(1000)));
+
+  TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_lock_hog, "lock_mid", 4096, NULL, base + 2, NULL, core));
+  TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_lock_waiter, "lock_high", 4096, NULL, base + 3, NULL, core));
+
+  // holder and waiter must finish while the hog still runs; stop the
+  // hog before asserting, a failed case must not starve the core
+  finished  = xSemaphoreTake(test_lock_done, pdMS_TO_TICKS(2000)) == pdTRUE;
+  finished &= xSemaphoreTake(test_lock_done, pdMS_TO_TICKS(2000)) == pdTRUE;
+
+  __atomic_store_n(&test_lock_stop, true, __ATOMIC_RELEASE);
+  vTaskPrioritySet(NULL, base);
+
+  TEST_ASSERT_TRUE(finished);
+  TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_lock_done, pdMS_TO_TICKS(1000)));
+  TEST_ASSERT_TRUE(test_lock_pushed);
+  TEST_ASSERT_LESS_OR_EQUAL_INT32(TEST_LOCK_MAX_WAIT_US, (int32_t)test_lock_wait_us);
+  TEST_ASSERT_EQUAL_UINT16(1, m_cfifo_This_GetUsage(&test_lock_cfifo));
+
+  vSemaphoreDelete(test_lock_cfifo.semaphore);
+  vSemaphoreDelete(test_lock_held);
+  vSemaphoreDelete(test_lock_done);
+}
@@ -0,0 +1,201 @@
+/**
+ * @file test_m_cfifo_mmap.c
+ * @brief Crash recovery of the memory-mapped FIFO (linux target).
+ *
+ * Damages header slots in the mapping directly, as a torn write would,
+ * and checks which state a reopened FIFO resumes from.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <unistd.h>
+#include "unity.h"
+#include "m_cfifo_mmap.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_MMAP_PATH "/tmp/m_cfifo_test_mmap.fifo"
+#define TEST_MMAP_SIZE 64
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("mmap falls back to the previous commit when the newest slot is torn", "[m_cfifo][mmap]")
+{
+  m_cfifo_tCFifo writer;
+  m_cfifo_tCFifo reader;
+  m_cfifo_tMmap mm_writer;
+  m_cfifo_tMmap mm_reader;
+  uint8_t data;
+
+  unlink(TEST_MMAP_PATH);
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&writer));
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_writer, &writer, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+
+  for (uint8_t i = 0; i < 10; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  for (uint8_t i = 10; i < 15; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  // crash in the middle of the second header write
+  mm_writer.header->slots[mm_writer.sequence & 1].wrPtr ^= 0x5;
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_reader, &reader, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+  TEST_ASSERT_EQUAL_UINT16(10, m_cfifo_This_GetUsage(&reader));
+
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&reader, &data));
+    TEST_ASSERT_EQUAL_UINT8(i, data);
+  }
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_writer));
+  unlink(TEST_MMAP_PATH);
+
+  vSemaphoreDelete(writer.semaphore);
+  vSemaphoreDelete(reader.semaphore);
+}
+
+TEST_CASE("mmap starts empty when both header slots are damaged", "[m_cfifo][mmap]")
+{
+  m_cfifo_tCFifo writer;
+  m_cfifo_tCFifo reader;
+  m_cfifo_tMmap mm_writer;
+  m_cfifo_tMmap mm_reader;
+
+  unlink(TEST_MMAP_PATH);
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&writer));
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_writer, &writer, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+  TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, 0x42));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  mm_writer.header->slots[0].checksum ^= 1;
+  mm_writer.header->slots[1].checksum ^= 1;
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_reader, &reader, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+  TEST_ASSERT_TRUE(m_cfifo_This_IsEmpty(&reader));
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_writer));
+  unlink(TEST_MMAP_PATH);
+
+  vSemaphoreDelete(writer.semaphore);
+  vSemaphoreDelete(reader.semaphore);
+}
+
+TEST_CASE("mmap restores a state with an early wrap gap", "[m_cfifo][mmap]")
+{
+  m_cfifo_tCFifo writer;
+  m_cfifo_tCFifo reader;
+  m_cfifo_tMmap mm_writer;
+  m_cfifo_tMmap mm_reader;
+  uint8_t* frame;
+  uint8_t data;
+
+  unlink(TEST_MMAP_PATH);
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&writer));
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_writer, &writer, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+
+  for (uint8_t i = 0; i < 40; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  for (uint8_t i = 0; i < 30; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&writer, &data));
+
+  // 24 bytes left up to the end: the frame wraps early and leaves a gap
+  frame = m_cfifo_This_Reserve(&writer, 28);
+  TEST_ASSERT_EQUAL_PTR(writer.buffer, frame);
+  for (uint8_t i = 0; i < 28; i++)
+    frame[i] = 100 + i;
+  TEST_ASSERT_TRUE(m_cfifo_This_WriteDone(&writer, 28));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_reader, &reader, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+  TEST_ASSERT_EQUAL_UINT16(38, m_cfifo_This_GetUsage(&reader));
+
+  for (uint8_t i = 30; i < 40; i++)
+  {
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&reader, &data));
+    TEST_ASSERT_EQUAL_UINT8(i, data);
+  }
+  for (uint8_t i = 0; i < 28; i++)
+  {
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&reader, &data));
+    TEST_ASSERT_EQUAL_UINT8(100 + i, data);
+  }
+  TEST_ASSERT_TRUE(m_cfifo_This_IsEmpty(&reader));
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_writer));
+  unlink(TEST_MMAP_PATH);
+
+  vSemaphoreDelete(writer.semaphore);
+  vSemaphoreDelete(reader.semaphore);
+}
+
+TEST_CASE("mmap does not resume bytes popped and overwritten since the commit", "[m_cfifo][mmap]")
+{
+  m_cfifo_tCFifo writer;
+  m_cfifo_tCFifo reader;
+  m_cfifo_tMmap mm_writer;
+  m_cfifo_tMmap mm_reader;
+  uint8_t data;
+
+  unlink(TEST_MMAP_PATH);
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&writer));
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_writer, &writer, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+
+  for (uint8_t i = 0; i < 40; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  // the write wraps into the space freed by the pops
+  for (uint8_t i = 0; i < 30; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&writer, &data));
+  for (uint8_t i = 100; i < 150; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Commit(&mm_writer));
+
+  // no commit from here: pops wrap the read position, pushes reuse its space
+  for (uint8_t i = 0; i < 30; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&writer, &data));
+  for (uint8_t i = 150; i < 170; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+  for (uint8_t i = 0; i < 6; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&writer, &data));
+  TEST_ASSERT_EQUAL_UINT16(2, writer.rdPtr);
+  for (uint8_t i = 170; i < 180; i++)
+    TEST_ASSERT_TRUE(m_cfifo_This_Push(&writer, i));
+
+  // crash: only the committed bytes not popped yet come back
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Open(&mm_reader, &reader, TEST_MMAP_PATH, TEST_MMAP_SIZE, M_CFIFO_MMAP_SYNC_NONE, 1));
+  TEST_ASSERT_EQUAL_UINT16(24, m_cfifo_This_GetUsage(&reader));
+
+  for (uint8_t i = 126; i < 150; i++)
+  {
+    TEST_ASSERT_TRUE(m_cfifo_This_Pop(&reader, &data));
+    TEST_ASSERT_EQUAL_UINT8(i, data);
+  }
+  TEST_ASSERT_TRUE(m_cfifo_This_IsEmpty(&reader));
+
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_reader));
+  TEST_ASSERT_TRUE(m_cfifo_Mmap_Close(&mm_writer));
+  unlink(TEST_MMAP_PATH);
+
+  vSemaphoreDelete(writer.semaphore);
+  vSemaphoreDelete(reader.semaphore);
+}
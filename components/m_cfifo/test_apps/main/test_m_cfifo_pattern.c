@@ -0,0 +1,127 @@
+/**
+ * @file test_m_cfifo_pattern.c
+ * @brief Randomized check of m_cfifo_This_FindPattern against a byte loop.
+ *
+ * A shadow copy of the FIFO content is searched with a plain byte loop
+ * after every random push/pop step. The FIFO has an odd size so the
+ * wrap point and the vector/word compares hit every alignment, and the
+ * bytes come from a small alphabet so partial matches are frequent.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_PATTERN_FIFO_SIZE 97
+#define TEST_PATTERN_MAX_LEN   5
+#define TEST_PATTERN_STEPS     20000
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_pattern_cfifo;
+static uint8_t test_pattern_buffer[TEST_PATTERN_FIFO_SIZE];
+static uint8_t test_pattern_shadow[TEST_PATTERN_FIFO_SIZE];
+static uint16_t test_pattern_used;
+static uint32_t test_pattern_seed = 0x2545F491u;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static uint32_t test_pattern_Random(void)
+{
+  // xorshift32, fixed seed so failures reproduce
+  test_pattern_seed ^= test_pattern_seed << 13;
+  test_pattern_seed ^= test_pattern_seed >> 17;
+  test_pattern_seed ^= test_pattern_seed << 5;
+  return test_pattern_seed;
+}
+
+static uint8_t test_pattern_RandomByte(void)
+{
+  static const uint8_t alphabet[] = {0x2D, 0xD4, 0x00, 0xFF};
+  uint32_t r = test_pattern_Random();
+
+  return (r & 0x30) ? alphabet[r & 3] : (uint8_t)(r >> 8);
+}
+
+static bool test_pattern_FindReference(const uint8_t* pattern, uint16_t length, uint16_t* offset)
+{
+  for (uint16_t i = 0; i + length <= test_pattern_used; i++)
+  {
+    if (memcmp(&test_pattern_shadow[i], pattern, length) == 0)
+    {
+      *offset = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("FindPattern matches a byte loop over random wrapped content", "[m_cfifo][pattern]")
+{
+  uint8_t pattern[TEST_PATTERN_MAX_LEN];
+  uint8_t data;
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_pattern_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_pattern_cfifo, test_pattern_buffer, sizeof(test_pattern_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_pattern_cfifo));
+  test_pattern_used = 0;
+
+  for (uint32_t step = 0; step < TEST_PATTERN_STEPS; step++)
+  {
+    uint16_t pops   = test_pattern_Random() % 24;
+    uint16_t pushes = test_pattern_Random() % 24;
+    uint16_t length = 1 + test_pattern_Random() % TEST_PATTERN_MAX_LEN;
+    uint16_t expected = 0;
+    uint16_t offset = 0;
+    bool found;
+
+    for (uint16_t i = 0; i < pops && test_pattern_used > 0; i++)
+    {
+      TEST_ASSERT_TRUE(m_cfifo_This_Pop(&test_pattern_cfifo, &data));
+      TEST_ASSERT_EQUAL_UINT8(test_pattern_shadow[0], data);
+      memmove(test_pattern_shadow, &test_pattern_shadow[1], --test_pattern_used);
+    }
+
+    for (uint16_t i = 0; i < pushes && test_pattern_used < TEST_PATTERN_FIFO_SIZE; i++)
+    {
+      data = test_pattern_RandomByte();
+      TEST_ASSERT_TRUE(m_cfifo_This_Push(&test_pattern_cfifo, data));
+      test_pattern_shadow[test_pattern_used++] = data;
+    }
+
+    // half of the patterns are cut from the content, so matches are common
+    if (test_pattern_used >= length && (test_pattern_Random() & 1))
+      memcpy(pattern, &test_pattern_shadow[test_pattern_Random() % (test_pattern_used - length + 1)], length);
+    else
+      for (uint16_t i = 0; i < length; i++)
+        pattern[i] = test_pattern_RandomByte();
+
+    found = m_cfifo_This_FindPattern(&test_pattern_cfifo, pattern, length, &offset);
+
+    TEST_ASSERT_EQUAL(test_pattern_FindReference(pattern, length, &expected), found);
+    if (found)
+      TEST_ASSERT_EQUAL_UINT16(expected, offset);
+  }
+
+  vSemaphoreDelete(test_pattern_cfifo.semaphore);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_m_cfifo_resize.c
+ * @brief Checks of m_cfifo_This_Resize.
+ *
+ * Content that wraps in the old buffer must come out of the new one in
+ * the original order, both when growing and when shrinking to exactly
+ * the stored size. A move is refused while the content does not fit or
+ * a write grant still points into the old buffer, and the peak usage
+ * never exceeds the new size.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_RESIZE_SMALL 16
+#define TEST_RESIZE_LARGE 32
+#define TEST_RESIZE_USED  12
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_resize_cfifo;
+static uint8_t test_resize_small[TEST_RESIZE_SMALL];
+static uint8_t test_resize_large[TEST_RESIZE_LARGE];
+static uint8_t test_resize_exact[TEST_RESIZE_USED];
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static uint16_t test_resize_Pop(uint8_t* data, uint16_t length)
+{
+  uint16_t count = 0;
+
+  while (count < length && m_cfifo_This_Pop(&test_resize_cfifo, &data[count]))
+    count++;
+
+  return count;
+}
+
+static void test_resize_Wrapped(uint8_t* expected)
+{
+  uint8_t data[TEST_RESIZE_SMALL];
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_resize_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_resize_cfifo, test_resize_small, sizeof(test_resize_small)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_resize_cfifo));
+
+  // fill completely for a peak of 16, then leave 12 bytes wrapping from offset 12
+  for (uint8_t i = 0; i < TEST_RESIZE_SMALL; i++)
+    data[i] = i;
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_SMALL, m_cfifo_This_PushBlock(&test_resize_cfifo, data, TEST_RESIZE_SMALL));
+  TEST_ASSERT_EQUAL_UINT16(12, test_resize_Pop(data, 12));
+
+  for (uint8_t i = 0; i < 8; i++)
+    data[i] = TEST_RESIZE_SMALL + i;
+  TEST_ASSERT_EQUAL_UINT16(8, m_cfifo_This_PushBlock(&test_resize_cfifo, data, 8));
+
+  for (uint8_t i = 0; i < TEST_RESIZE_USED; i++)
+    expected[i] = 12 + i;
+
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, m_cfifo_This_GetUsage(&test_resize_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_SMALL, m_cfifo_This_GetPeak(&test_resize_cfifo, false));
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("Resize linearizes wrapped content into a larger buffer", "[m_cfifo][resize]")
+{
+  uint8_t expected[TEST_RESIZE_USED];
+  uint8_t data[TEST_RESIZE_LARGE];
+
+  test_resize_Wrapped(expected);
+
+  memset(test_resize_large, 0, sizeof(test_resize_large));
+  TEST_ASSERT_TRUE(m_cfifo_This_Resize(&test_resize_cfifo, test_resize_large, sizeof(test_resize_large)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, test_resize_large, TEST_RESIZE_USED);
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, m_cfifo_This_GetUsage(&test_resize_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_LARGE, m_cfifo_This_GetSize(&test_resize_cfifo));
+
+  // writing continues directly behind the moved bytes
+  for (uint8_t i = 0; i < TEST_RESIZE_LARGE - TEST_RESIZE_USED; i++)
+    data[i] = 0x80 + i;
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_LARGE - TEST_RESIZE_USED, m_cfifo_This_PushBlock(&test_resize_cfifo, data, TEST_RESIZE_LARGE - TEST_RESIZE_USED));
+  TEST_ASSERT_FALSE(m_cfifo_This_Push(&test_resize_cfifo, 0xFF));
+
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_LARGE, test_resize_Pop(data, sizeof(data)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, TEST_RESIZE_USED);
+  for (uint8_t i = TEST_RESIZE_USED; i < TEST_RESIZE_LARGE; i++)
+    TEST_ASSERT_EQUAL_UINT8(0x80 + i - TEST_RESIZE_USED, data[i]);
+
+  vSemaphoreDelete(test_resize_cfifo.semaphore);
+}
+
+TEST_CASE("Resize shrinks to the stored size and clamps the peak", "[m_cfifo][resize]")
+{
+  uint8_t expected[TEST_RESIZE_USED];
+  uint8_t data[TEST_RESIZE_SMALL];
+
+  test_resize_Wrapped(expected);
+
+  // one byte short of the content: refused, nothing changes
+  TEST_ASSERT_FALSE(m_cfifo_This_Resize(&test_resize_cfifo, test_resize_exact, TEST_RESIZE_USED - 1));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, m_cfifo_This_GetUsage(&test_resize_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_SMALL, m_cfifo_This_GetSize(&test_resize_cfifo));
+
+  TEST_ASSERT_TRUE(m_cfifo_This_Resize(&test_resize_cfifo, test_resize_exact, sizeof(test_resize_exact)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, test_resize_exact, TEST_RESIZE_USED);
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, m_cfifo_This_GetSize(&test_resize_cfifo));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, m_cfifo_This_GetPeak(&test_resize_cfifo, false));
+  TEST_ASSERT_FALSE(m_cfifo_This_Push(&test_resize_cfifo, 0xFF));
+
+  // pop half, push across the end of the new buffer, the order holds
+  TEST_ASSERT_EQUAL_UINT16(6, test_resize_Pop(data, 6));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, 6);
+  for (uint8_t i = 0; i < 6; i++)
+    data[i] = 0x40 + i;
+  TEST_ASSERT_EQUAL_UINT16(6, m_cfifo_This_PushBlock(&test_resize_cfifo, data, 6));
+
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED, test_resize_Pop(data, sizeof(data)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&expected[6], data, 6);
+  for (uint8_t i = 0; i < 6; i++)
+    TEST_ASSERT_EQUAL_UINT8(0x40 + i, data[6 + i]);
+
+  vSemaphoreDelete(test_resize_cfifo.semaphore);
+}
+
+TEST_CASE("Resize is refused while a write grant is outstanding", "[m_cfifo][resize]")
+{
+  uint8_t expected[TEST_RESIZE_USED];
+  uint8_t data[TEST_RESIZE_LARGE];
+  uint8_t grant_id;
+  uint8_t* region;
+
+  test_resize_Wrapped(expected);
+
+  region = m_cfifo_This_Grant(&test_resize_cfifo, 2, &grant_id);
+  TEST_ASSERT_NOT_NULL(region);
+  TEST_ASSERT_FALSE(m_cfifo_This_Resize(&test_resize_cfifo, test_resize_large, sizeof(test_resize_large)));
+
+  // the grant still fills the old buffer and publishes as usual
+  region[0] = 0xA0;
+  region[1] = 0xA1;
+  TEST_ASSERT_TRUE(m_cfifo_This_Commit(&test_resize_cfifo, grant_id, 2));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED + 2, m_cfifo_This_GetUsage(&test_resize_cfifo));
+
+  TEST_ASSERT_TRUE(m_cfifo_This_Resize(&test_resize_cfifo, test_resize_large, sizeof(test_resize_large)));
+  TEST_ASSERT_EQUAL_UINT16(TEST_RESIZE_USED + 2, test_resize_Pop(data, sizeof(data)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, TEST_RESIZE_USED);
+  TEST_ASSERT_EQUAL_UINT8(0xA0, data[TEST_RESIZE_USED]);
+  TEST_ASSERT_EQUAL_UINT8(0xA1, data[TEST_RESIZE_USED + 1]);
+
+  vSemaphoreDelete(test_resize_cfifo.semaphore);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_m_cfifo_spsc.c
+ * @brief Stress test of the lock-free SPSC cascade.
+ *
+ * A producer task and the test task stream a counting byte sequence
+ * through a cascade of small segments, so segment switches, wrap
+ * points and pool recycling happen thousands of times. Block and
+ * single-byte calls are mixed on both sides.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "m_cfifo_spsc.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_SPSC_BYTES     200000u
+#define TEST_SPSC_SEGMENTS  4
+#define TEST_SPSC_SEG_SIZE  61
+#define TEST_SPSC_CHUNK_MAX 37
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tSpsc test_spsc;
+static m_cfifo_tCFifo test_spsc_segments[TEST_SPSC_SEGMENTS];
+static uint8_t test_spsc_buffers[TEST_SPSC_SEGMENTS][TEST_SPSC_SEG_SIZE];
+static SemaphoreHandle_t test_spsc_done;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void test_spsc_producer(void* arg)
+{
+  uint8_t chunk[TEST_SPSC_CHUNK_MAX];
+  uint32_t sent = 0;
+  uint32_t round = 0;
+
+  (void)arg;
+
+  while (sent < TEST_SPSC_BYTES)
+  {
+    uint32_t length = 1 + round++ % TEST_SPSC_CHUNK_MAX;
+    uint32_t written;
+
+    if (length > TEST_SPSC_BYTES - sent)
+      length = TEST_SPSC_BYTES - sent;
+
+    for (uint32_t i = 0; i < length; i++)
+      chunk[i] = (uint8_t)(sent + i);
+
+    if (round % 4 == 0)
+      written = m_cfifo_Spsc_Push(&test_spsc, chunk[0]) ? 1 : 0;
+    else
+      written = m_cfifo_Spsc_Write(&test_spsc, chunk, length);
+
+    sent += written;
+
+    if (written == 0)
+      taskYIELD();
+  }
+
+  xSemaphoreGive(test_spsc_done);
+  vTaskDelete(NULL);
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("spsc cascade keeps order under concurrent producer and consumer", "[m_cfifo][spsc][stress]")
+{
+  uint8_t chunk[TEST_SPSC_CHUNK_MAX];
+  uint32_t received = 0;
+  bool grown = false;
+
+  test_spsc_done = xSemaphoreCreateBinary();
+  TEST_ASSERT_NOT_NULL(test_spsc_done);
+
+  TEST_ASSERT_TRUE(m_cfifo_Spsc_Init(&test_spsc, &test_spsc_segments[0], test_spsc_buffers[0], TEST_SPSC_SEG_SIZE));
+  TEST_ASSERT_TRUE(m_cfifo_Spsc_AddSegment(&test_spsc, &test_spsc_segments[1], test_spsc_buffers[1], TEST_SPSC_SEG_SIZE));
+
+  TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_spsc_producer, "spsc_prod", 4096, NULL, uxTaskPriorityGet(NULL), NULL));
+
+  while (received < TEST_SPSC_BYTES)
+  {
+    uint32_t length;
+
+    // grow the pool while the producer is running
+    if (!grown && received >= TEST_SPSC_BYTES / 2)
+    {
+      for (uint8_t i = 2; i < TEST_SPSC_SEGMENTS; i++)
+        TEST_ASSERT_TRUE(m_cfifo_Spsc_AddSegment(&test_spsc, &test_spsc_segments[i], test_spsc_buffers[i], TEST_SPSC_SEG_SIZE));
+
+      grown = true;
+    }
+
+    if (received % 3 == 0)
+      length = m_cfifo_Spsc_Pop(&test_spsc, chunk) ? 1 : 0;
+    else
+      length = m_cfifo_Spsc_Read(&test_spsc, chunk, 1 + received % TEST_SPSC_CHUNK_MAX);
+
+    for (uint32_t i = 0; i < length; i++)
+      TEST_ASSERT_EQUAL_UINT8((uint8_t)(received + i), chunk[i]);
+
+    received += length;
+
+    if (length == 0)
+      taskYIELD();
+  }
+
+  TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_spsc_done, pdMS_TO_TICKS(1000)));
+  TEST_ASSERT_TRUE(m_cfifo_Spsc_IsEmpty(&test_spsc));
+
+  vSemaphoreDelete(test_spsc_done);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_m_cfifo_transform.c
+ * @brief Randomized check of m_cfifo_This_PopBlockTransform against a reference.
+ *
+ * Random pushes and transformed pops run on a FIFO of odd size, so the
+ * content wraps at every alignment and byte-swapped words straddle the
+ * wrap point. Every pop is compared with a plain per-byte reference
+ * transform of a shadow copy; the bit reversal is computed bit by bit,
+ * independent of the lookup table.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_TRANSFORM_FIFO_SIZE 97
+#define TEST_TRANSFORM_MAX_LEN   40
+#define TEST_TRANSFORM_STEPS     20000
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_transform_cfifo;
+static uint8_t test_transform_buffer[TEST_TRANSFORM_FIFO_SIZE];
+static uint8_t test_transform_shadow[TEST_TRANSFORM_FIFO_SIZE];
+static uint16_t test_transform_used;
+static uint32_t test_transform_seed = 0x6C8E9CF5u;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static uint32_t test_transform_Random(void)
+{
+  // xorshift32, fixed seed so failures reproduce
+  test_transform_seed ^= test_transform_seed << 13;
+  test_transform_seed ^= test_transform_seed >> 17;
+  test_transform_seed ^= test_transform_seed << 5;
+  return test_transform_seed;
+}
+
+static uint8_t test_transform_BitReverse(uint8_t value)
+{
+  uint8_t reversed = 0;
+
+  for (uint8_t bit = 0; bit < 8; bit++)
+    if (value & (1u << bit))
+      reversed |= (uint8_t)(0x80u >> bit);
+
+  return reversed;
+}
+
+static uint16_t test_transform_Reference(uint8_t* data, uint16_t length, m_cfifo_tTransform transform, uint8_t mask)
+{
+  uint16_t word = transform == M_CFIFO_TRANSFORM_BSWAP32 ? 4 : transform == M_CFIFO_TRANSFORM_BSWAP16 ? 2 : 1;
+  uint16_t count = length < test_transform_used ? length : test_transform_used;
+
+  count -= count % word;
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    uint8_t value = test_transform_shadow[i];
+
+    switch (transform)
+    {
+      case M_CFIFO_TRANSFORM_XOR:
+        value ^= mask;
+        break;
+
+      case M_CFIFO_TRANSFORM_BITREV:
+        value = test_transform_BitReverse(value);
+        break;
+
+      case M_CFIFO_TRANSFORM_BSWAP16:
+      case M_CFIFO_TRANSFORM_BSWAP32:
+        // byte i of a word comes from the mirrored position
+        value = test_transform_shadow[i - i % word + word - 1 - i % word];
+        break;
+
+      default:
+        break;
+    }
+
+    data[i] = value;
+  }
+
+  test_transform_used -= count;
+  memmove(test_transform_shadow, &test_transform_shadow[count], test_transform_used);
+
+  return count;
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("PopBlockTransform matches a reference over random wrapped content", "[m_cfifo][transform]")
+{
+  uint8_t data[TEST_TRANSFORM_MAX_LEN];
+  uint8_t expected[TEST_TRANSFORM_MAX_LEN];
+  uint8_t block[TEST_TRANSFORM_MAX_LEN];
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_transform_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_transform_cfifo, test_transform_buffer, sizeof(test_transform_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_transform_cfifo));
+  test_transform_used = 0;
+
+  for (uint32_t step = 0; step < TEST_TRANSFORM_STEPS; step++)
+  {
+    uint16_t pushes = test_transform_Random() % TEST_TRANSFORM_MAX_LEN;
+    uint16_t length = test_transform_Random() % (TEST_TRANSFORM_MAX_LEN + 1);
+    m_cfifo_tTransform transform = (m_cfifo_tTransform)(test_transform_Random() % (M_CFIFO_TRANSFORM_BSWAP32 + 1));
+    uint8_t mask = (uint8_t)test_transform_Random();
+    uint16_t popped;
+    uint16_t count;
+
+    if (pushes > TEST_TRANSFORM_FIFO_SIZE - test_transform_used)
+      pushes = TEST_TRANSFORM_FIFO_SIZE - test_transform_used;
+
+    for (uint16_t i = 0; i < pushes; i++)
+      block[i] = (uint8_t)test_transform_Random();
+
+    TEST_ASSERT_EQUAL_UINT16(pushes, m_cfifo_This_PushBlock(&test_transform_cfifo, block, pushes));
+    memcpy(&test_transform_shadow[test_transform_used], block, pushes);
+    test_transform_used += pushes;
+
+    popped = m_cfifo_This_PopBlockTransform(&test_transform_cfifo, data, length, transform, mask);
+    count  = test_transform_Reference(expected, length, transform, mask);
+
+    TEST_ASSERT_EQUAL_UINT16(count, popped);
+    if (count > 0)
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, count);
+    TEST_ASSERT_EQUAL_UINT16(test_transform_used, m_cfifo_This_GetUsage(&test_transform_cfifo));
+  }
+
+  vSemaphoreDelete(test_transform_cfifo.semaphore);
+}
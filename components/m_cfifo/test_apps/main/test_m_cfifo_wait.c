@@ -0,0 +1,130 @@
+/**
+ * @file test_m_cfifo_wait.c
+ * @brief Wake-up of m_cfifo_This_PopBlockWait by zero-copy producers.
+ *
+ * A producer task writes after the consumer went to sleep, without a
+ * push: once through the write descriptors and WriteDone, as a DMA
+ * completion does, and once through a write grant. The waiting consumer
+ * must return with the data long before its timeout.
+ *
+ * @author Martin Langbein
+ * @date 2026-10-17
+ * @copyright GPLv2
+ */
+
+
+#include <string.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "m_cfifo.h"
+
+
+//*****************************************************************************
+// Local Defines
+//*****************************************************************************
+#define TEST_WAIT_LENGTH     16
+#define TEST_WAIT_DELAY_MS   20
+#define TEST_WAIT_TIMEOUT_MS 2000
+#define TEST_WAIT_MAX_MS     500
+
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+static m_cfifo_tCFifo test_wait_cfifo;
+static uint8_t test_wait_buffer[64];
+static SemaphoreHandle_t test_wait_done;
+static bool test_wait_written;
+
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void test_wait_dma_producer(void* arg)
+{
+  m_cfifo_tDescriptor desc[2];
+
+  (void)arg;
+
+  vTaskDelay(pdMS_TO_TICKS(TEST_WAIT_DELAY_MS));
+
+  test_wait_written = m_cfifo_This_GetWriteDescriptors(&test_wait_cfifo, desc, 2) > 0 &&
+                      desc[0].length >= TEST_WAIT_LENGTH;
+  if (test_wait_written)
+  {
+    memset(desc[0].address, 0x5A, TEST_WAIT_LENGTH);
+    test_wait_written = m_cfifo_This_WriteDone(&test_wait_cfifo, TEST_WAIT_LENGTH);
+  }
+
+  xSemaphoreGive(test_wait_done);
+  vTaskDelete(NULL);
+}
+
+static void test_wait_grant_producer(void* arg)
+{
+  uint8_t* region;
+  uint8_t id;
+
+  (void)arg;
+
+  vTaskDelay(pdMS_TO_TICKS(TEST_WAIT_DELAY_MS));
+
+  region = m_cfifo_This_Grant(&test_wait_cfifo, TEST_WAIT_LENGTH, &id);
+  test_wait_written = region != NULL;
+  if (test_wait_written)
+  {
+    memset(region, 0x5A, TEST_WAIT_LENGTH);
+    test_wait_written = m_cfifo_This_Commit(&test_wait_cfifo, id, TEST_WAIT_LENGTH);
+  }
+
+  xSemaphoreGive(test_wait_done);
+  vTaskDelete(NULL);
+}
+
+static void test_wait_Run(TaskFunction_t producer)
+{
+  uint8_t data[TEST_WAIT_LENGTH];
+  TickType_t start;
+  uint16_t received;
+
+  test_wait_done    = xSemaphoreCreateBinary();
+  test_wait_written = false;
+  TEST_ASSERT_NOT_NULL(test_wait_done);
+
+  TEST_ASSERT_TRUE(m_cfifo_InitBuffer(&test_wait_cfifo));
+  TEST_ASSERT_TRUE(m_cfifo_ConfigBuffer(&test_wait_cfifo, test_wait_buffer, sizeof(test_wait_buffer)));
+  TEST_ASSERT_TRUE(m_cfifo_This_Clear(&test_wait_cfifo));
+
+  TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(producer, "wait_producer", 4096, NULL, uxTaskPriorityGet(NULL), NULL));
+
+  start    = xTaskGetTickCount();
+  received = m_cfifo_This_PopBlockWait(&test_wait_cfifo, data, sizeof(data), pdMS_TO_TICKS(TEST_WAIT_TIMEOUT_MS));
+
+  TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_wait_done, pdMS_TO_TICKS(TEST_WAIT_TIMEOUT_MS)));
+  TEST_ASSERT_TRUE(test_wait_written);
+  TEST_ASSERT_EQUAL_UINT16(TEST_WAIT_LENGTH, received);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(pdMS_TO_TICKS(TEST_WAIT_MAX_MS), xTaskGetTickCount() - start);
+  for (uint8_t i = 0; i < TEST_WAIT_LENGTH; i++)
+    TEST_ASSERT_EQUAL_UINT8(0x5A, data[i]);
+
+  vSemaphoreDelete(test_wait_cfifo.semaphore);
+  vSemaphoreDelete(test_wait_done);
+}
+
+
+//*****************************************************************************
+// Test Cases
+//*****************************************************************************
+
+TEST_CASE("PopBlockWait wakes on WriteDone after a DMA-style write", "[m_cfifo][wait]")
+{
+  test_wait_Run(test_wait_dma_producer);
+}
+
+TEST_CASE("PopBlockWait wakes on a committed write grant", "[m_cfifo][wait]")
+{
+  test_wait_Run(test_wait_grant_producer);
+}
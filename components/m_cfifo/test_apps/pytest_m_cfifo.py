@@ -0,0 +1,9 @@
+import pytest
+from pytest_embedded import Dut
+
+
+@pytest.mark.linux
+@pytest.mark.host_test
+@pytest.mark.generic
+def test_m_cfifo(dut: Dut) -> None:
+    dut.expect_unity_test_output(timeout=600)
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Convert an m_cfifo trace dump into Chrome/Perfetto trace JSON.
+
+The input is the byte stream written by m_cfifo_Trace_Dump(): a
+m_cfifo_tTraceHeader followed by m_cfifo_tTraceEvent records
+(little endian). The output can be opened in chrome://tracing or
+https://ui.perfetto.dev.
+
+- CPU cores become processes, tasks become threads.
+- Push/pop/call events become instant events.
+- BLOCK..WAKE pairs become duration slices ("blocked on <fifo>"); a
+  WAKE without a BLOCK of the same task marks the task that woke a
+  waiting consumer.
+- Task switches become per-core "running <task>" slices.
+
+Usage: m_cfifo_trace2json.py trace.bin [trace.json]
+"""
+
+import json
+import struct
+import sys
+
+MAGIC = 0x5446434D
+HEADER = struct.Struct("<IHHI")
+EVENT = struct.Struct("<QIIHBB4x")
+
+TYPES = ["call", "push", "pop", "block", "wake", "task_switch"]
+
+# keep in sync with m_cfifo_tTraceApi in m_cfifo_trace.h
+APIS = [
+    "CascadeAsNextBuffer", "ConfigBuffer", "SetDummyByte",
+    "This_Push", "This_PushBlock", "All_Push",
+    "This_Pop", "All_Pop",
+    "This_Clear", "All_Clear",
+    "This_SetFull", "All_SetFull",
+    "This_GetSize", "All_GetSize",
+    "This_GetUsage", "All_GetUsage",
+    "This_IsEmpty", "All_IsEmpty",
+    "This_IsFull", "All_IsFull",
+    "This_GetReadDescriptors", "All_GetReadDescriptors",
+    "This_GetWriteDescriptors", "All_GetWriteDescriptors",
+    "This_ReadDone", "All_ReadDone",
+    "This_WriteDone", "All_WriteDone",
+    "Pool_Acquire", "Pool_Release",
+    "Producer_Write", "Producer_Flush",
+    "Spsc_Push", "Spsc_Write", "Spsc_Pop", "Spsc_Read",
+    "Producer_Push",
+    "InitBuffer", "InitBufferStatic",
+    "This_Resize", "This_GetState", "This_RestoreState",
+    "SetReleaseHook",
+    "Shm_Write", "Shm_Read",
+    "This_PopBlock", "SetRateLimit", "GetRateLimitDelay",
+    "This_FindPattern", "This_PopBlockTransform",
+    "Audio_Write", "Audio_Read",
+    "This_PopBlockWait",
+    "Deque_Push", "Deque_Pop", "Deque_Steal",
+    "Shard_PushTo", "Shard_Pop",
+    "SetLockPolicy", "GetLockStats",
+    "InitBufferLock",
+    "SetLatencyHistogram", "GetLatencyHistogram",
+    "This_GetPeak", "All_PushBlock", "All_PopBlock",
+    "This_Read", "This_Ack", "This_Rewind",
+    "GetStreamOffsets", "SetStreamOffset", "This_PeekAt", "This_SkipTo",
+    "This_Reserve", "This_Grant", "This_Commit",
+    "This_Abort", "This_PublishGrants",
+    "This_CommitFromISR",
+]
+
+
+def api_name(arg):
+    return APIS[arg] if arg < len(APIS) else "api_%d" % arg
+
+
+def parse(data):
+    magic, version, event_size, count = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not an m_cfifo trace dump")
+    if version != 1 or event_size != EVENT.size:
+        raise ValueError("unsupported dump version %d / event size %d" % (version, event_size))
+    offset = HEADER.size
+    for _ in range(count):
+        yield EVENT.unpack_from(data, offset)
+        offset += EVENT.size
+
+
+def convert(events):
+    out = []
+    running = {}   # core -> (task, ts)
+    blocked = set()   # tasks with an open "blocked on" slice
+    last_ts = 0
+
+    for ts, fifo, task, arg, etype, core in events:
+        last_ts = max(last_ts, ts)
+        name = TYPES[etype] if etype < len(TYPES) else "type_%d" % etype
+        base = {"ts": ts, "pid": core, "tid": task}
+
+        if name == "task_switch":
+            prev = running.get(core)
+            if prev is not None:
+                out.append({"name": "running 0x%08x" % prev[0], "ph": "X",
+                            "ts": prev[1], "dur": ts - prev[1],
+                            "pid": core, "tid": 0})
+            running[core] = (task, ts)
+        elif name == "block":
+            blocked.add(task)
+            out.append(dict(base, name="blocked on 0x%08x" % fifo, ph="B",
+                            args={"api": api_name(arg)}))
+        elif name == "wake" and task in blocked:
+            blocked.discard(task)
+            out.append(dict(base, name="blocked on 0x%08x" % fifo, ph="E"))
+        elif name == "wake":
+            out.append(dict(base, name="wake", ph="i", s="t",
+                            args={"fifo": "0x%08x" % fifo, "api": api_name(arg)}))
+        elif name == "call":
+            out.append(dict(base, name=api_name(arg), ph="i", s="t",
+                            args={"fifo": "0x%08x" % fifo}))
+        else:
+            out.append(dict(base, name=name, ph="i", s="t",
+                            args={"fifo": "0x%08x" % fifo, "bytes": arg}))
+
+    for core, (task, ts) in running.items():
+        out.append({"name": "running 0x%08x" % task, "ph": "X", "ts": ts,
+                    "dur": last_ts - ts, "pid": core, "tid": 0})
+
+    for core in sorted({e["pid"] for e in out}):
+        out.append({"name": "process_name", "ph": "M", "pid": core,
+                    "args": {"name": "core %d" % core}})
+
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    with open(argv[1], "rb") as f:
+        trace = convert(parse(f.read()))
+
+    if len(argv) == 3:
+        with open(argv[2], "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))